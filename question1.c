@@ -3,10 +3,20 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <stddef.h>
 #include <time.h>
 #include <ctype.h>
+#include <math.h>
 #include <windows.h>
 
+// SIMD scan kernels are built for x86 GCC/MinGW and picked at runtime
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define SCAN_X86 1
+#else
+#define SCAN_X86 0
+#endif
+
 
 
 #define MAX_RECORDS 500
@@ -37,6 +47,382 @@ typedef struct {
 Record records[MAX_RECORDS];
 int recordCount = 0;
 
+// Column copies of the scanned fields, slot-aligned with records[]
+int idColumn[MAX_RECORDS];
+float priceColumn[MAX_RECORDS];
+int dateKeyColumn[MAX_RECORDS];
+
+// Case-folded name and category per slot, with hashes of the folded text,
+// so case-insensitive comparisons never fold at query time
+char nameFoldedColumn[MAX_RECORDS][MAX_NAME_LENGTH];
+char categoryFoldedColumn[MAX_RECORDS][20];
+unsigned int nameHashColumn[MAX_RECORDS];
+unsigned int categoryHashColumn[MAX_RECORDS];
+
+// Sorted views: permutation arrays over records[] kept in key order as the
+// store changes, so several orderings are available without moving records
+#define VIEW_STORED -1
+#define VIEW_PRICE 0
+#define VIEW_DATE 1
+#define VIEW_COUNT 2
+
+typedef struct {
+    const char* name;
+    int (*compare)(const Record* a, const Record* b);
+    int order[MAX_RECORDS];   // Slots into records[], ascending by compare
+    int count;
+} SortedView;
+
+// Trigram index over lowercased product names: each bucket lists the slots
+// whose name contains a trigram hashing to it (collisions are re-checked)
+#define TRIGRAM_BUCKETS 4096
+
+typedef struct {
+    int* slots;      // Record slots in ascending order
+    int count;
+    int capacity;
+} PostingList;
+
+PostingList trigramIndex[TRIGRAM_BUCKETS];
+int trigramIndexIncomplete = 0;   // A posting list could not grow; searches scan instead
+
+// Record-slot bitmaps: one bit per slot in records[]
+#define BITMAP_WORDS ((MAX_RECORDS + 63) / 64)
+
+typedef struct {
+    unsigned long long words[BITMAP_WORDS];
+} Bitmap;
+
+// Category index: member bitmap per case-folded category name. Entries are
+// dropped when their last record goes, so there is never more than one per
+// record and every category is indexed (also bounds the per-category totals,
+// digests and samples)
+#define MAX_INDEXED_CATEGORIES MAX_RECORDS
+
+typedef struct {
+    char key[20];        // Lowercased category name
+    unsigned int hash;   // foldedHash(key)
+    Bitmap members;
+} CategoryIndexEntry;
+
+CategoryIndexEntry categoryIndex[MAX_INDEXED_CATEGORIES];
+int categoryIndexCount = 0;
+
+// Running per-category totals, rebuilt on load and kept by the mutation hooks;
+// min/max are refreshed from the category bitmap only after a removal may
+// have taken away an extreme value
+typedef struct {
+    char key[20];            // Lowercased category name
+    unsigned int hash;       // foldedHash(key)
+    char name[20];           // Display text of the first record seen
+    int count;
+    double value;
+    float min;
+    float max;
+    int extremesStale;
+} CategoryTotal;
+
+CategoryTotal categoryTotals[MAX_INDEXED_CATEGORIES];
+int categoryTotalCount = 0;
+
+// Price t-digest per category (same position as its CategoryTotal): merged
+// centroids followed by buffered prices, compressed when the buffer fills.
+// A digest cannot forget a price, so a removal marks it stale and it is
+// rebuilt from the category bitmap the next time it is read
+#define DIGEST_COMPRESSION 50
+#define DIGEST_CENTROIDS (2 * DIGEST_COMPRESSION)
+#define DIGEST_BUFFER 128
+
+typedef struct {
+    double mean;
+    double weight;
+} Centroid;
+
+typedef struct {
+    Centroid centroids[DIGEST_CENTROIDS + DIGEST_BUFFER];
+    int centroidCount;       // Merged centroids, in mean order
+    int bufferCount;         // Unmerged points after them
+    double totalWeight;
+    float min;
+    float max;
+    int stale;
+} PriceDigest;
+
+PriceDigest categoryDigests[MAX_INDEXED_CATEGORIES];
+
+// Price histogram: fixed-width buckets up to the $100,000 price limit
+#define PRICE_BUCKET_WIDTH 100
+#define PRICE_BUCKETS (100000 / PRICE_BUCKET_WIDTH + 1)
+
+int priceBucketCount[PRICE_BUCKETS];
+double priceBucketValue[PRICE_BUCKETS];
+
+// Calendar rollup: value received per day on a fixed 31-day-per-month grid
+// (2000-2100, the range validateDate accepts), with running month and year
+// totals and Fenwick trees over the days so any date window is O(log n)
+#define CALENDAR_FIRST_YEAR 2000
+#define CALENDAR_YEARS 101
+#define CALENDAR_MONTHS (CALENDAR_YEARS * 12)
+#define CALENDAR_DAYS (CALENDAR_MONTHS * 31)
+
+int dayCountTree[CALENDAR_DAYS + 1];     // Fenwick trees, 1-based
+double dayValueTree[CALENDAR_DAYS + 1];
+int monthCount[CALENDAR_MONTHS];
+double monthValue[CALENDAR_MONTHS];
+int yearCount[CALENDAR_YEARS];
+double yearValue[CALENDAR_YEARS];
+int undatedCount = 0;                    // Dates outside the calendar
+double undatedValue = 0;
+
+// Stratified sample for approximate aggregates: a reservoir of up to
+// SAMPLE_CAPACITY records per category (same position as its
+// CategoryIndexEntry). Removals are paired with later insertions (random
+// pairing) so each reservoir stays a uniform sample of its category; one that
+// has shrunk below half its size is redrawn from the bitmap when queried
+#define SAMPLE_CAPACITY 64
+#define SAMPLE_Z95 1.96
+
+typedef struct {
+    int id;
+    float price;
+    int dateKey;
+} SampleItem;
+
+typedef struct {
+    SampleItem items[SAMPLE_CAPACITY];
+    int count;               // Items held
+    int population;          // Records in the category
+    int removedInside;       // Removals not yet paired: sampled ones...
+    int removedOutside;      // ...and ones that were not in the sample
+} CategorySample;
+
+CategorySample categorySamples[MAX_INDEXED_CATEGORIES];
+unsigned long long sampleRandomState = 0x9E3779B97F4A7C15ULL;
+
+// Fuzzy name search: one match per record slot with its edit distance
+typedef struct {
+    int slot;
+    int distance;
+} FuzzyMatch;
+
+// Model index on (category, product name): one entry per model with its
+// unit count, total value and member slots, sorted by case-folded key
+typedef struct {
+    char categoryKey[20];             // Lowercased category
+    char nameKey[MAX_NAME_LENGTH];    // Lowercased product name
+    char category[20];                // Display text of the first unit seen
+    char productName[MAX_NAME_LENGTH];
+    int count;
+    double value;
+    Bitmap members;
+} ModelEntry;
+
+ModelEntry modelIndex[MAX_RECORDS];
+int modelCount = 0;
+
+// Group-by engine: hash table (open addressing) of aggregates per group key
+#define GROUP_BY_CATEGORY 0
+#define GROUP_BY_PRODUCT 1
+#define GROUP_BY_MONTH 2
+#define GROUP_BY_PRICE_BAND 3
+#define GROUP_BY_COUNT 4
+#define GROUP_TABLE_SIZE 1024     // Power of two, over twice MAX_RECORDS
+#define GROUP_TABLE_MIN_SIZE 16
+#define GROUP_KEY_LENGTH 80
+#define REPORT_PRICE_BAND 500
+
+typedef struct {
+    char key[GROUP_KEY_LENGTH];     // Match key (names case-folded)
+    char label[GROUP_KEY_LENGTH];   // Display text of the first record seen
+    int used;                       // Slot holds a group (any key, even empty)
+    long rank;                      // Numeric order (month, band); 0 = by key
+    int count;
+    double sum;
+    float min;
+    float max;
+} GroupAggregate;
+
+// Slots live outside the table so a partition's tables can be sized to the
+// partition rather than to the whole store
+typedef struct {
+    GroupAggregate* slots;
+    unsigned int mask;              // Slot count - 1 (a power of two)
+    int groupCount;
+} GroupTable;
+
+GroupTable reportGroups[GROUP_BY_COUNT];
+GroupAggregate reportGroupSlots[GROUP_BY_COUNT][GROUP_TABLE_SIZE];
+
+// Table rows are formatted by hand into one reusable buffer and written out
+// in large chunks, since stdout is unbuffered and printf parses its format
+// for every row
+#define ROW_BUFFER_SIZE (64 * 1024)
+#define TABLE_ROW_LENGTH 192       // Longest possible row, including a rank column
+char rowBuffer[ROW_BUFFER_SIZE];
+size_t rowBufferLength = 0;
+FILE* rowOutput = NULL;            // Where flushed rows go; NULL = stdout
+
+// Machine-readable exports (CSV, JSON Lines, binary columnar)
+#define EXPORT_REPORT 1
+#define EXPORT_CSV 2
+#define EXPORT_JSONL 3
+#define EXPORT_COLUMNAR 4
+#define EXPORT_ROW_LENGTH 640      // Longest JSON line: every name byte escaped as \u00XX
+#define COLUMNAR_MAGIC "APCOL1"
+#define COLUMNAR_NAME_LENGTH 16
+#define COLUMN_INT32 1
+#define COLUMN_FLOAT32 2
+#define COLUMN_STRING 3
+
+// Snapshot diff: hash join on ID between an earlier and a later snapshot
+#define DIFF_TABLE_SIZE 1024       // Power of two, over twice MAX_RECORDS
+
+Record diffBefore[MAX_RECORDS];
+Record diffAfter[MAX_RECORDS];
+
+// Scheduled reports: a background thread writes a report every interval from
+// the snapshot the menu loop last published between commands, so it never
+// reads records[] while the foreground is changing it. The previous report
+// is gzipped into a numbered archive, keeping SCHEDULE_KEEP_ARCHIVES
+#define SCHEDULE_DEFAULT_MINUTES 15
+#define SCHEDULE_REPORT "apple_store_scheduled.txt"
+#define SCHEDULE_TEMP "apple_store_scheduled.tmp"
+#define SCHEDULE_ARCHIVE_TEMP "apple_store_scheduled.gz.tmp"
+#define SCHEDULE_ARCHIVE "apple_store_scheduled.%d.txt.gz"
+#define SCHEDULE_KEEP_ARCHIVES 8
+#define SCHEDULE_STATUS_LENGTH 120
+
+typedef struct {
+    Record records[MAX_RECORDS];
+    int recordCount;
+    CategoryTotal totals[MAX_INDEXED_CATEGORIES];   // Fresh extremes
+    PriceDigest digests[MAX_INDEXED_CATEGORIES];    // Compressed, not stale
+    int categoryCount;
+    unsigned long generation;                       // dataGeneration when taken
+    time_t takenAt;
+} StoreSnapshot;
+
+StoreSnapshot publishedSnapshot;       // Written by the menu loop under snapshotLock
+StoreSnapshot reportSnapshot;          // Scheduler thread's own copy
+CRITICAL_SECTION snapshotLock;
+int snapshotLockReady = 0;
+HANDLE schedulerThread = NULL;
+volatile int schedulerStop = 0;
+int scheduleMinutes = SCHEDULE_DEFAULT_MINUTES;
+unsigned long reportedGeneration = 0;  // Scheduler thread only
+int scheduledReportCount = 0;          // Status fields: under snapshotLock
+time_t lastScheduledReport = 0;
+char scheduleStatus[SCHEDULE_STATUS_LENGTH] = "Not started";
+
+// gzip output: LZ77 matches over a hash chain, coded with deflate's fixed
+// Huffman codes in a single block
+#define GZIP_WINDOW 32768
+#define GZIP_HASH_BITS 12
+#define GZIP_MAX_CHAIN 32
+#define GZIP_MIN_MATCH 3
+#define GZIP_MAX_MATCH 258
+
+typedef struct {
+    FILE* file;
+    unsigned long bits;      // Pending bits, least significant first
+    int count;
+} BitWriter;
+
+// Parallel report: rows are split into a fixed number of partitions so the
+// output and merged totals do not depend on how many threads ran them
+#define REPORT_PARTITIONS 8
+#define REPORT_MIN_PARALLEL_ROWS 256
+#define REPORT_ROW_LENGTH 160      // Longest possible formatted row, with margin
+
+typedef struct {
+    int from;                     // First record slot of the partition
+    int to;                       // One past the last slot
+    const int* groupBys;
+    int groupCount;
+    char* buffer;                 // Formatted table rows
+    size_t length;
+    GroupTable groups[GROUP_BY_COUNT];  // Partial aggregates, indexed by grouping
+    GroupAggregate* groupSlots;   // Storage for the requested groupings only
+} ReportPartition;
+
+typedef struct {
+    ReportPartition* partitions;
+    int first;                    // Partitions first, first + stride, ...
+    int stride;
+} ReportWorker;
+
+// Counting Bloom filter over record IDs: a zero counter at any of an ID's
+// positions proves the ID is absent without touching records[]
+#define BLOOM_COUNTERS 8192
+#define BLOOM_HASHES 4
+
+unsigned char bloomCounters[BLOOM_COUNTERS];
+
+// Query result cache: matching-slot bitmaps of recent queries keyed by
+// normalized query text, valid only while dataGeneration is unchanged
+#define QUERY_CACHE_SIZE 16
+#define QUERY_KEY_LENGTH 256
+
+typedef struct {
+    char key[QUERY_KEY_LENGTH];
+    unsigned long generation;    // dataGeneration when stored (0 = empty)
+    unsigned long lastUsed;      // queryCacheClock at last hit, for LRU
+    Bitmap result;
+} QueryCacheEntry;
+
+QueryCacheEntry queryCache[QUERY_CACHE_SIZE];
+unsigned long dataGeneration = 1;   // Bumped whenever records[] changes
+unsigned long queryCacheClock = 0;
+
+// Name tries: radix trees over lowercased product and category names used
+// for prefix completion; live counts let lookups skip dead subtrees
+#define MAX_SUGGESTIONS 10
+
+typedef struct TrieNode {
+    char* label;               // Lowercased edge text into this node
+    char* word;                // Display text when a name ends here
+    int count;                 // Records using the name
+    int pinned;                // Catalog name, suggested even without records
+    int live;                  // Names in this subtree with count > 0 or pinned
+    struct TrieNode* child;    // First child; siblings are sorted by label
+    struct TrieNode* sibling;
+} TrieNode;
+
+TrieNode productTrie;
+TrieNode categoryTrie;
+
+// Scan kernel in use (detected on first scan)
+#define SCAN_SCALAR 0
+#define SCAN_SSE41 1
+#define SCAN_AVX2 2
+
+int scanLevel = -1;
+
+// Combined query: predicates joined by AND, e.g. "category=iPhones AND price>500"
+#define MAX_QUERY_PREDICATES 8
+#define MAX_QUERY_LENGTH 200
+
+#define FIELD_ID 1
+#define FIELD_PRICE 2
+#define FIELD_DATE 3
+#define FIELD_NAME 4
+#define FIELD_CATEGORY 5
+
+#define OP_EQ 1
+#define OP_LT 2
+#define OP_LE 3
+#define OP_GT 4
+#define OP_GE 5
+#define OP_CONTAINS 6
+
+typedef struct {
+    int field;
+    int op;
+    double number;               // id, price, or date key
+    char text[MAX_NAME_LENGTH];  // Lowercased name/category value
+    unsigned int hash;           // foldedHash(text)
+} QueryPredicate;
+
 // Apple Product Lists (Shortened names for better display)
 const char* iphones[] = {
     "iPhone 15 Pro Max",
@@ -78,8 +464,101 @@ void displayAllRecords();
 void searchMenu();
 void searchByID();
 void searchByDate();
+void searchByDateRange();
+int dateIndexLowerBound(int key);
 void searchByName();
+int myersDistance(const unsigned long long* peq, int patternLength, const char* text);
+int compareFuzzyMatches(const void* a, const void* b);
+int fuzzySearchByName(const char* queryLower);
 void searchByCategory();
+void topKQuery();
+void combinedQuery();
+void searchByPriceRange();
+void priceBandSummary();
+void stockTimeline();
+int promptDateKey(const char* prompt);
+void approximateAggregates();
+void stockByModel();
+int modelLowerBound(const char* categoryKey, const char* nameKey);
+void modelIndexAdd(int slot, const Record* r, int direction);
+void rebuildModelIndex();
+size_t appendPaddedText(char* out, const char* text, int width);
+size_t appendPaddedInt(char* out, long value, int width);
+size_t appendPaddedMoney(char* out, float value, int width);
+size_t formatRecordRow(char* out, const Record* r);
+char* reserveOutput(size_t length);
+char* reserveRow();
+void setRowOutput(FILE* file);
+void printRecordRow(const Record* r);
+void flushRows();
+unsigned int groupHash(const char* key);
+long groupKeyFor(const Record* r, int groupBy, char* key, char* label, size_t size);
+unsigned int groupSlotsFor(int rows);
+void groupTableInit(GroupTable* table, GroupAggregate* slots, unsigned int slotCount);
+void groupTableReset(GroupTable* table);
+GroupAggregate* groupFind(GroupTable* table, const char* key, const char* label, long rank);
+void groupByRecords(GroupTable* tables, const int* groupBys, int count);
+void groupByRange(GroupTable* tables, const int* groupBys, int count, const Record* source, int from, int to);
+void groupMerge(GroupTable* into, const GroupTable* from);
+void formatReportPartition(ReportPartition* partition);
+DWORD WINAPI reportWorkerMain(LPVOID arg);
+int reportThreadCount();
+int writeReportRows(FILE* file, const int* groupBys, int groupCount);
+int compareGroups(const void* a, const void* b);
+int sortedGroups(GroupTable* table, GroupAggregate** out);
+void writeGroupSummary(FILE* file, const char* title, GroupTable* table);
+int priceBucket(float price);
+void priceHistogramAdd(const Record* r, int direction);
+void rebuildPriceHistogram();
+int calendarDay(int key);
+void calendarAdd(const Record* r, int direction);
+void rebuildCalendar();
+void calendarPrefix(int day, int* count, double* value);
+void calendarWindow(int fromKey, int toKey, int* count, double* value);
+int sampleRandom(int n);
+void sampleAdd(const Record* r);
+void sampleRemove(const Record* r);
+void sampleReplace(const Record* before, const Record* after);
+void resampleCategory(int index);
+void rebuildSamples();
+int approximateAggregate(const char* category, int fromKey, int toKey, float minPrice, float maxPrice,
+                         double estimates[3], double margins[3], int* population);
+void setColumns(int slot);
+unsigned int foldedHash(const char* folded);
+int detectScanLevel();
+const char* scanLevelName();
+void scanIntRange(const int* column, int count, int lo, int hi, Bitmap* out);
+void scanFloatRange(const float* column, int count, float lo, int loInclusive, float hi, int hiInclusive, Bitmap* out);
+int findSlotByID(int id);
+unsigned long long mixID(int id);
+void bloomPositions(int id, unsigned int* positions);
+void bloomAdd(int id);
+void bloomRemove(int id);
+int bloomMayContain(int id);
+void rebuildBloomFilter();
+TrieNode* trieNewNode(const char* label, int length);
+void trieAdjust(TrieNode* root, const char* text, int countDelta, int pin);
+void trieCollect(const TrieNode* node, const TrieNode** out, int* found, int max);
+int trieComplete(const TrieNode* root, const char* prefix, const TrieNode** out, int max);
+void trieFree(TrieNode* node);
+void trieClear(TrieNode* root);
+void pinCatalogNames();
+void rebuildNameTries();
+void completeFromSuggestions(char* text, size_t size);
+void suggestNames();
+int parseQuery(const char* text, QueryPredicate* predicates, int* count);
+int isAndWord(const char* text);
+char* predicateAfter(char* text);
+int queryFieldNamed(const char* name);
+void planQuery(const QueryPredicate* predicates, int predicateCount, Bitmap* out, int* residual);
+int normalizeQuery(const QueryPredicate* predicates, int predicateCount, char* key, size_t size);
+const Bitmap* queryCacheLookup(const char* key);
+void queryCacheStore(const char* key, const Bitmap* result);
+int parsePredicate(char* text, QueryPredicate* predicate);
+int predicateMatches(const QueryPredicate* predicate, int slot);
+double viewKey(int viewId, int slot);
+int viewLowerBound(int viewId, double key, int strict);
+void viewRangeToBitmap(int viewId, int from, int to, Bitmap* out);
 void deleteByID();
 void updateRecord();
 void sortRecords();
@@ -90,6 +569,40 @@ void sortByDateAscending();
 void sortByDateDescending();
 int compareDates(char* date1, char* date2);
 void exportReport();
+void exportMenu();
+size_t appendCsvField(char* out, const char* text);
+size_t appendJsonString(char* out, const char* text);
+size_t appendIsoDate(char* out, int key);
+int writeCsvExport(FILE* file);
+int writeJsonLinesExport(FILE* file);
+void writeUint32(FILE* file, unsigned int value);
+void writeWordColumn(FILE* file, const void* values, int count);
+void writeColumnHeader(FILE* file, const char* name, unsigned int type, unsigned int byteLength);
+void writeStringColumn(FILE* file, const char* name, size_t fieldOffset);
+int writeColumnarExport(FILE* file);
+int exportFormatFromName(const char* name);
+int exportData(int format, const char* filename);
+int loadSnapshot(const char* filename, Record* out);
+void diffSnapshots(const Record* before, int beforeCount, const Record* after, int afterCount);
+void compareSnapshots();
+void publishSnapshot();
+void publishSnapshotIfChanged();
+void setScheduleStatus(const char* status);
+void writeScheduledReportFile(FILE* file, StoreSnapshot* snapshot);
+int fileExists(const char* path);
+int rotateScheduledReports();
+int writeScheduledReport(StoreSnapshot* snapshot);
+DWORD WINAPI schedulerMain(LPVOID arg);
+int startScheduler(int minutes);
+void stopScheduler();
+void scheduledReportsMenu();
+unsigned long crc32Update(unsigned long crc, const unsigned char* data, size_t length);
+void bitWrite(BitWriter* writer, unsigned int value, int count);
+void bitWriteCode(BitWriter* writer, unsigned int code, int length);
+void deflateLiteral(BitWriter* writer, int symbol);
+void deflateMatch(BitWriter* writer, int length, int distance);
+int gzipFile(const char* source, const char* target);
+int parseRecordLine(char* line, Record* out);
 void loadFromFile();
 void saveToFile();
 void clearScreen();
@@ -100,13 +613,88 @@ int getProductChoice(int category);
 void createCategoryInteractive();
 void toLowerCase(const char* src, char* dest, size_t size);
 int generateNextID(int categoryChoice);
+void displayRecordsMenu();
+void displayRecordsInView(int viewId, int descending);
+int dateToKey(const char* date);
+int compareByPrice(const Record* a, const Record* b);
+int compareByDate(const Record* a, const Record* b);
+void viewInsertSlot(SortedView* view, int slot);
+void viewRemoveSlot(SortedView* view, int slot);
+void rebuildViews();
+unsigned int trigramBucket(const char* s);
+void postingAdd(PostingList* list, int slot);
+void postingRemove(PostingList* list, int slot);
+int postingLowerBound(const PostingList* list, int slot);
+int postingContains(const PostingList* list, int slot);
+void trigramIndexName(int slot, const char* name, int add);
+void rebuildTrigramIndex();
+void bitmapSet(Bitmap* b, int slot);
+void bitmapClearBit(Bitmap* b, int slot);
+int bitmapTest(const Bitmap* b, int slot);
+int bitmapCount(const Bitmap* b);
+int bitmapNext(const Bitmap* b, int from);
+void bitmapRemoveSlot(Bitmap* b, int slot);
+CategoryIndexEntry* findCategoryEntry(const char* category, int create);
+void dropEmptyCategory(const char* category);
+void rebuildCategoryIndex();
+CategoryTotal* findCategoryTotal(const char* category, int create);
+void categoryTotalAdd(const Record* r, int direction);
+void refreshCategoryExtremes(CategoryTotal* total);
+void rebuildCategoryTotals();
+int compareCategoryTotals(const void* a, const void* b);
+void writeCategoryTotals(FILE* file);
+void writeCategorySummary(FILE* file, const CategoryTotal* totals, int count);
+int compareCentroids(const void* a, const void* b);
+void digestCompress(PriceDigest* digest);
+void digestAdd(PriceDigest* digest, double price, double weight);
+void digestMerge(PriceDigest* into, PriceDigest* from);
+double digestQuantile(PriceDigest* digest, double q);
+PriceDigest* categoryDigest(const CategoryTotal* total);
+void writePriceDistribution(FILE* file);
+void writeDigestSummary(FILE* file, const CategoryTotal* totals, PriceDigest* digests, int count, int itemCount);
+void indexInsertRecord(int slot);
+void indexDeleteRecord(int slot);
+void indexUpdateRecord(int slot, const Record* before);
+void rebuildIndexes();
+
+SortedView views[VIEW_COUNT] = {
+    {.name = "Price", .compare = compareByPrice},
+    {.name = "Date", .compare = compareByDate}
+};
 
 // ============================================================================
 // MAIN FUNCTION
 // ============================================================================
-int main() {
+int main(int argc, char* argv[]) {
     int choice;
     
+    // Command-line diff: question1 --diff old.txt [new.txt] (default: the data file)
+    if (argc >= 3 && strcmp(argv[1], "--diff") == 0) {
+        int beforeCount = loadSnapshot(argv[2], diffBefore);
+        int afterCount = loadSnapshot(argc >= 4 ? argv[3] : FILENAME, diffAfter);
+        if (beforeCount < 0 || afterCount < 0) {
+            fprintf(stderr, "[ERROR] Cannot open snapshot %s!\n", beforeCount < 0 ? argv[2] : (argc >= 4 ? argv[3] : FILENAME));
+            return 1;
+        }
+        diffSnapshots(diffBefore, beforeCount, diffAfter, afterCount);
+        return 0;
+    }
+    
+    // Command-line export: question1 --export csv|jsonl|columnar|report [file]
+    if (argc >= 3 && strcmp(argv[1], "--export") == 0) {
+        int format = exportFormatFromName(argv[2]);
+        if (format == 0) {
+            fprintf(stderr, "[ERROR] Unknown export format '%s' (use csv, jsonl, columnar or report)\n", argv[2]);
+            return 1;
+        }
+        loadFromFile();
+        if (format == EXPORT_REPORT) {
+            exportReport();
+            return 0;
+        }
+        return exportData(format, argc >= 4 ? argv[3] : NULL) < 0 ? 1 : 0;
+    }
+    
     // Set stdout to unbuffered mode for immediate output in debugger
     setvbuf(stdout, NULL, _IONBF, 0);
     
@@ -128,6 +716,7 @@ int main() {
     
     // Main program loop
     while(1) {
+        publishSnapshotIfChanged();
         displayMenu();
         printCenteredNoNL(">>> Enter your choice (1-8): ");
         fflush(stdout);
@@ -149,7 +738,7 @@ int main() {
                 insertRecord();
                 break;
             case 2:
-                displayAllRecords();
+                displayRecordsMenu();
                 break;
             case 3:
                 searchMenu();
@@ -164,9 +753,10 @@ int main() {
                 updateRecord();
                 break;
             case 7:
-                exportReport();
+                exportMenu();
                 break;
             case 8:
+                stopScheduler();
                 printf("\nSaving all data...\n");
                 saveToFile();
                 printf("[OK] Data saved successfully!\n");
@@ -217,7 +807,7 @@ void displayMenu() {
     printCentered("*   4. Delete a Record by ID                               *");
     printCentered("*   5. Sort Records                                        *");
     printCentered("*   6. Update an Existing Record                           *");
-    printCentered("*   7. Export Stock Report                                 *");
+    printCentered("*   7. Export Report / Data (CSV, JSON, Columnar)          *");
     printCentered("*   8. Exit and Save                                       *");
     printCentered("*                                                          *");
     printCentered("************************************************************");
@@ -234,11 +824,9 @@ int validateID(int id) {
     }
     
     // Check for duplicate ID
-    for (int i = 0; i < recordCount; i++) {
-        if (records[i].id == id) {
-            printf("[ERROR] ID %d already exists!\n", id);
-            return 0;
-        }
+    if (findSlotByID(id) >= 0) {
+        printf("[ERROR] ID %d already exists!\n", id);
+        return 0;
     }
     return 1;
 }
@@ -565,11 +1153,52 @@ void createCategoryInteractive() {
 
     printf("[OK] Category '%s' created with %d product(s).\n", customCategories[customCategoryCount], customProductCount[customCategoryCount]);
     customCategoryCount++;
+    pinCatalogNames();
 }
 
 // ============================================================================
 // FILE OPERATIONS
 // ============================================================================
+// Parse one line: ID|ProductName|Price|Date|Category
+// Returns 1 on success, 0 if the line is malformed (line is modified in place)
+int parseRecordLine(char* line, Record* out) {
+    char *p = line;
+    char *end;
+    
+    // Get ID
+    out->id = (int)strtol(p, &end, 10);
+    if (end == p || *end != '|') return 0;
+    p = end + 1;
+    
+    // Get Product Name
+    end = strchr(p, '|');
+    if (end == NULL) return 0;
+    *end = '\0';
+    strncpy(out->productName, p, MAX_NAME_LENGTH - 1);
+    out->productName[MAX_NAME_LENGTH - 1] = '\0';
+    p = end + 1;
+    
+    // Get Price
+    out->price = (float)strtod(p, &end);
+    if (end == p || *end != '|') return 0;
+    p = end + 1;
+    
+    // Get Date
+    end = strchr(p, '|');
+    if (end == NULL) return 0;
+    *end = '\0';
+    strncpy(out->date, p, MAX_DATE_LENGTH - 1);
+    out->date[MAX_DATE_LENGTH - 1] = '\0';
+    p = end + 1;
+    
+    // Get Category (rest of line, remove newline)
+    end = strpbrk(p, "\r\n");
+    if (end != NULL) *end = '\0';
+    strncpy(out->category, p, 19);
+    out->category[19] = '\0';
+    return 1;
+}
+
 void loadFromFile() {
     FILE *file = fopen(FILENAME, "r");
     
@@ -581,46 +1210,16 @@ void loadFromFile() {
     recordCount = 0;
     char line[300];
     while (recordCount < MAX_RECORDS && fgets(line, sizeof(line), file) != NULL) {
-        // Parse: ID|ProductName|ItemNumber|Price|Date|Category
-        char *p = line;
-        char *end;
-        
-        // Get ID
-        records[recordCount].id = (int)strtol(p, &end, 10);
-        if (end == p || *end != '|') continue;
-        p = end + 1;
-        
-        // Get Product Name
-        end = strchr(p, '|');
-        if (end == NULL) continue;
-        *end = '\0';
-        strncpy(records[recordCount].productName, p, MAX_NAME_LENGTH - 1);
-        records[recordCount].productName[MAX_NAME_LENGTH - 1] = '\0';
-        p = end + 1;
-        
-        // Get Price
-        records[recordCount].price = (float)strtod(p, &end);
-        if (end == p || *end != '|') continue;
-        p = end + 1;
-        
-        // Get Date
-        end = strchr(p, '|');
-        if (end == NULL) continue;
-        *end = '\0';
-        strncpy(records[recordCount].date, p, MAX_DATE_LENGTH - 1);
-        records[recordCount].date[MAX_DATE_LENGTH - 1] = '\0';
-        p = end + 1;
-        
-        // Get Category (rest of line, remove newline)
-        end = strchr(p, '\n');
-        if (end != NULL) *end = '\0';
-        strncpy(records[recordCount].category, p, 19);
-        records[recordCount].category[19] = '\0';
-        
-        recordCount++;
+        if (parseRecordLine(line, &records[recordCount])) {
+            recordCount++;
+        }
     }
     
     fclose(file);
+    rebuildIndexes();
+    
+    rebuildBloomFilter();
+    rebuildCategoryTotals();
 }
 
 void saveToFile() {
@@ -669,11 +1268,11 @@ int generateNextID(int categoryChoice) {
     }
     
     // Find the maximum ID in the same category range
-    for (int i = 0; i < recordCount; i++) {
-        if (records[i].id >= baseID + 1 && records[i].id < baseID + 1000) {
-            if (records[i].id > maxID) {
-                maxID = records[i].id;
-            }
+    Bitmap inRange;
+    scanIntRange(idColumn, recordCount, baseID + 1, baseID + 999, &inRange);
+    for (int i = bitmapNext(&inRange, 0); i >= 0; i = bitmapNext(&inRange, i + 1)) {
+        if (idColumn[i] > maxID) {
+            maxID = idColumn[i];
         }
     }
     
@@ -682,119 +1281,2051 @@ int generateNextID(int categoryChoice) {
 }
 
 // ============================================================================
-// CORE OPERATIONS
+// SORTED VIEWS
 // ============================================================================
 
-// 1. INSERT NEW RECORD
-void insertRecord() {
-    Record newRecord;
-    int categoryChoice;
-    int productChoice;
-    int itemsToAdd;
+// Convert a DD/MM/YYYY date into a sortable YYYYMMDD key (0 if malformed)
+int dateToKey(const char* date) {
+    static const int digitPositions[] = {0, 1, 3, 4, 6, 7, 8, 9};
     
-    while (1) {
-        printf("\n==============================================================\n");
-        printf("              INSERT NEW RECORD                               \n");
-        printf("==============================================================\n\n");
+    if (date == NULL || strlen(date) != 10 || date[2] != '/' || date[5] != '/') {
+        return 0;
+    }
+    for (int i = 0; i < 8; i++) {
+        if (!isdigit((unsigned char)date[digitPositions[i]])) return 0;
+    }
     
-    // Check if array is full
-    if (recordCount >= MAX_RECORDS) {
-            printf("[ERROR] Maximum records limit reached (%d)!\n", MAX_RECORDS);
-            printf("Press Enter to continue...");
-            fflush(stdout);
-            getchar();
-        return;
+    int day = (date[0] - '0') * 10 + (date[1] - '0');
+    int month = (date[3] - '0') * 10 + (date[4] - '0');
+    int year = (date[6] - '0') * 1000 + (date[7] - '0') * 100 + (date[8] - '0') * 10 + (date[9] - '0');
+    return year * 10000 + month * 100 + day;
+}
+
+int compareByPrice(const Record* a, const Record* b) {
+    if (a->price < b->price) return -1;
+    if (a->price > b->price) return 1;
+    return 0;
+}
+
+int compareByDate(const Record* a, const Record* b) {
+    int keyA = dateToKey(a->date);
+    int keyB = dateToKey(b->date);
+    if (keyA < keyB) return -1;
+    if (keyA > keyB) return 1;
+    return 0;
+}
+
+// Place a slot after any entries with an equal key (binary search + shift)
+void viewInsertSlot(SortedView* view, int slot) {
+    int low = 0, high = view->count;
+    
+    while (low < high) {
+        int mid = (low + high) / 2;
+        if (view->compare(&records[view->order[mid]], &records[slot]) <= 0) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
     }
     
-        // Display category menu
-        displayCategoryMenu();
-        categoryChoice = getCategoryChoice();
-        
-        if (categoryChoice == -1) {
-            return;  // User chose to go back
+    memmove(&view->order[low + 1], &view->order[low], (view->count - low) * sizeof(int));
+    view->order[low] = slot;
+    view->count++;
+}
+
+// Remove a slot from a view; records[slot] must still hold the indexed key
+void viewRemoveSlot(SortedView* view, int slot) {
+    int low = 0, high = view->count;
+    
+    // Find the first entry with the same key, then scan the run of equal keys
+    while (low < high) {
+        int mid = (low + high) / 2;
+        if (view->compare(&records[view->order[mid]], &records[slot]) < 0) {
+            low = mid + 1;
+        } else {
+            high = mid;
         }
-        if (categoryChoice == -2) {
-            // Create new category
-            createCategoryInteractive();
-            continue; // show category menu again
+    }
+    
+    for (int i = low; i < view->count; i++) {
+        if (view->order[i] == slot) {
+            memmove(&view->order[i], &view->order[i + 1], (view->count - i - 1) * sizeof(int));
+            view->count--;
+            return;
         }
-        
-        // Display product submenu for selected category
-        displayProductSubmenu(categoryChoice);
-        productChoice = getProductChoice(categoryChoice);
-        
-        if (productChoice == -1) {
-            continue;  // Go back to category menu
+    }
+}
+
+// First position in the date view whose date key is >= key
+int dateIndexLowerBound(int key) {
+    int low = 0, high = views[VIEW_DATE].count;
+    
+    while (low < high) {
+        int mid = (low + high) / 2;
+        if (dateToKey(records[views[VIEW_DATE].order[mid]].date) < key) {
+            low = mid + 1;
+        } else {
+            high = mid;
         }
-        
-        // Get quantity to add (1-5)
-        printf("Enter quantity to add (1-5): ");
-        fflush(stdout);
-        if (scanf("%d", &itemsToAdd) != 1) {
-        clearInputBuffer();
-            printf("[ERROR] Invalid quantity format!\n");
-            printf("Press Enter to continue...");
-            fflush(stdout);
-            getchar();
-            continue;
+    }
+    return low;
+}
+
+// Sort key of records[slot] in a view (price, or YYYYMMDD date key)
+double viewKey(int viewId, int slot) {
+    if (viewId == VIEW_PRICE) return records[slot].price;
+    return dateToKey(records[slot].date);
+}
+
+// First view position whose key is >= key (or > key when strict)
+int viewLowerBound(int viewId, double key, int strict) {
+    int low = 0, high = views[viewId].count;
+    
+    while (low < high) {
+        int mid = (low + high) / 2;
+        double midKey = viewKey(viewId, views[viewId].order[mid]);
+        if (midKey < key || (strict && midKey == key)) {
+            low = mid + 1;
+        } else {
+            high = mid;
         }
-        
-        if (itemsToAdd < 1 || itemsToAdd > 5) {
-            printf("[ERROR] Quantity must be between 1 and 5!\n");
-            printf("Press Enter to continue...");
-            fflush(stdout);
-            getchar();
-            continue;
+    }
+    return low;
+}
+
+void rebuildViews() {
+    for (int v = 0; v < VIEW_COUNT; v++) {
+        views[v].count = 0;
+        for (int i = 0; i < recordCount; i++) {
+            viewInsertSlot(&views[v], i);
         }
-        
-    clearInputBuffer();
-        
-        // Set product name and category (common for all items)
-        if (categoryChoice == 1) {
-            strcpy(newRecord.productName, iphones[productChoice - 1]);
-            strcpy(newRecord.category, "iPhones");
-        } else if (categoryChoice == 2) {
-            strcpy(newRecord.productName, macbooks[productChoice - 1]);
-            strcpy(newRecord.category, "MacBooks");
-        } else if (categoryChoice == 3) {
-            strcpy(newRecord.productName, iwatch[productChoice - 1]);
-            strcpy(newRecord.category, "iWatch");
-        } else {
-            // Custom category
-            int customIndex = categoryChoice - 4;
-            if (customIndex >= 0 && customIndex < customCategoryCount) {
-                if (customProductCount[customIndex] > 0) {
-                    // user selected a listed product
-                    strcpy(newRecord.productName, customProducts[customIndex][productChoice - 1]);
-                } else {
-                    // No predefined products - prompt for product name
-                    char pname[MAX_NAME_LENGTH];
-                    printf("Enter Product Name: ");
-                    fflush(stdout);
-                    if (fgets(pname, sizeof(pname), stdin) == NULL) {
-                        pname[0] = '\0';
-                    }
-                    pname[strcspn(pname, "\n")] = 0;
-                    if (strlen(pname) == 0) {
-                        printf("[ERROR] Product name cannot be empty!\n");
-                        continue;
-                    }
-                    strncpy(newRecord.productName, pname, MAX_NAME_LENGTH - 1);
-                    newRecord.productName[MAX_NAME_LENGTH - 1] = '\0';
-                }
-                strncpy(newRecord.category, customCategories[customIndex], 19);
-                newRecord.category[19] = '\0';
-            } else {
-                printf("[ERROR] Invalid category selected!\n");
-                continue;
+    }
+}
+
+// ============================================================================
+// TRIGRAM NAME INDEX
+// ============================================================================
+
+// Bucket for the three (already lowercased) characters at s
+unsigned int trigramBucket(const char* s) {
+    unsigned int h = (unsigned char)s[0];
+    h = h * 31u + (unsigned char)s[1];
+    h = h * 31u + (unsigned char)s[2];
+    return (h * 2654435761u) >> 20;  // Top 12 bits -> 0..4095
+}
+
+int postingLowerBound(const PostingList* list, int slot) {
+    int low = 0, high = list->count;
+    while (low < high) {
+        int mid = (low + high) / 2;
+        if (list->slots[mid] < slot) low = mid + 1;
+        else high = mid;
+    }
+    return low;
+}
+
+// Insert slot keeping the list sorted; a slot is stored at most once
+void postingAdd(PostingList* list, int slot) {
+    int pos = postingLowerBound(list, slot);
+    if (pos < list->count && list->slots[pos] == slot) return;
+    
+    if (list->count == list->capacity) {
+        int newCapacity = list->capacity ? list->capacity * 2 : 8;
+        int* grown = (int*)realloc(list->slots, newCapacity * sizeof(int));
+        if (grown == NULL) {
+            // The slot is missing from this list, so the index can no longer
+            // rule records out; name searches scan every record until a rebuild
+            if (!trigramIndexIncomplete) {
+                printf("[WARNING] Not enough memory for the name index; name searches will scan all records.\n");
             }
+            trigramIndexIncomplete = 1;
+            return;
         }
-        
-        // Get Price (common for all items)
-        printf("Enter Price ($): ");
-        fflush(stdout);
-        if (scanf("%f", &newRecord.price) != 1) {
-            clearInputBuffer();
+        list->slots = grown;
+        list->capacity = newCapacity;
+    }
+    memmove(&list->slots[pos + 1], &list->slots[pos], (list->count - pos) * sizeof(int));
+    list->slots[pos] = slot;
+    list->count++;
+}
+
+void postingRemove(PostingList* list, int slot) {
+    int pos = postingLowerBound(list, slot);
+    if (pos < list->count && list->slots[pos] == slot) {
+        memmove(&list->slots[pos], &list->slots[pos + 1], (list->count - pos - 1) * sizeof(int));
+        list->count--;
+    }
+}
+
+int postingContains(const PostingList* list, int slot) {
+    int pos = postingLowerBound(list, slot);
+    return pos < list->count && list->slots[pos] == slot;
+}
+
+// Add (add=1) or remove (add=0) every trigram of name for a record slot
+void trigramIndexName(int slot, const char* name, int add) {
+    char lower[MAX_NAME_LENGTH];
+    toLowerCase(name, lower, sizeof(lower));
+    
+    for (int i = 0; lower[i] != '\0' && lower[i + 1] != '\0' && lower[i + 2] != '\0'; i++) {
+        PostingList* list = &trigramIndex[trigramBucket(&lower[i])];
+        if (add) {
+            postingAdd(list, slot);
+        } else {
+            postingRemove(list, slot);
+        }
+    }
+}
+
+void rebuildTrigramIndex() {
+    trigramIndexIncomplete = 0;
+    for (int b = 0; b < TRIGRAM_BUCKETS; b++) {
+        trigramIndex[b].count = 0;
+    }
+    for (int i = 0; i < recordCount; i++) {
+        trigramIndexName(i, records[i].productName, 1);
+    }
+}
+
+// ============================================================================
+// CATEGORY BITMAP INDEX
+// ============================================================================
+void bitmapSet(Bitmap* b, int slot) {
+    b->words[slot / 64] |= 1ULL << (slot % 64);
+}
+
+void bitmapClearBit(Bitmap* b, int slot) {
+    b->words[slot / 64] &= ~(1ULL << (slot % 64));
+}
+
+int bitmapTest(const Bitmap* b, int slot) {
+    return (b->words[slot / 64] >> (slot % 64)) & 1;
+}
+
+int bitmapCount(const Bitmap* b) {
+    int count = 0;
+    for (int w = 0; w < BITMAP_WORDS; w++) {
+        count += __builtin_popcountll(b->words[w]);
+    }
+    return count;
+}
+
+// Next set slot at or after from, or -1 if none
+int bitmapNext(const Bitmap* b, int from) {
+    if (from >= BITMAP_WORDS * 64) return -1;
+    int w = from / 64;
+    unsigned long long bits = b->words[w] & (~0ULL << (from % 64));
+    
+    while (1) {
+        if (bits != 0) {
+            return w * 64 + __builtin_ctzll(bits);
+        }
+        if (++w >= BITMAP_WORDS) return -1;
+        bits = b->words[w];
+    }
+}
+
+// Drop a slot and move every higher slot down by one, matching the shift
+// deleteByID applies to records[]
+void bitmapRemoveSlot(Bitmap* b, int slot) {
+    int w = slot / 64;
+    int bit = slot % 64;
+    unsigned long long low = b->words[w] & ((1ULL << bit) - 1);
+    unsigned long long high = (bit == 63) ? 0 : (b->words[w] >> (bit + 1)) << bit;
+    
+    b->words[w] = low | high;
+    for (int i = w; i < BITMAP_WORDS - 1; i++) {
+        b->words[i] |= (b->words[i + 1] & 1ULL) << 63;
+        b->words[i + 1] >>= 1;
+    }
+}
+
+// Look up a category by case-folded name, optionally adding it
+CategoryIndexEntry* findCategoryEntry(const char* category, int create) {
+    char key[20];
+    toLowerCase(category, key, sizeof(key));
+    unsigned int hash = foldedHash(key);
+    
+    for (int i = 0; i < categoryIndexCount; i++) {
+        if (categoryIndex[i].hash == hash && strcmp(categoryIndex[i].key, key) == 0) return &categoryIndex[i];
+    }
+    if (!create || categoryIndexCount >= MAX_INDEXED_CATEGORIES) return NULL;
+    
+    memset(&categorySamples[categoryIndexCount], 0, sizeof(CategorySample));
+    CategoryIndexEntry* entry = &categoryIndex[categoryIndexCount++];
+    strcpy(entry->key, key);
+    entry->hash = hash;
+    memset(&entry->members, 0, sizeof(entry->members));
+    return entry;
+}
+
+// Bitmap of the slots at view positions [from, to)
+void viewRangeToBitmap(int viewId, int from, int to, Bitmap* out) {
+    memset(out, 0, sizeof(Bitmap));
+    for (int pos = from; pos < to; pos++) {
+        bitmapSet(out, views[viewId].order[pos]);
+    }
+}
+
+// Remove a category's entry (and its sample) once it has no records left
+void dropEmptyCategory(const char* category) {
+    CategoryIndexEntry* entry = findCategoryEntry(category, 0);
+    if (entry == NULL || bitmapNext(&entry->members, 0) >= 0) return;
+    
+    int index = (int)(entry - categoryIndex);
+    int tail = categoryIndexCount - index - 1;
+    memmove(&categoryIndex[index], &categoryIndex[index + 1], tail * sizeof(CategoryIndexEntry));
+    memmove(&categorySamples[index], &categorySamples[index + 1], tail * sizeof(CategorySample));
+    categoryIndexCount--;
+}
+
+void rebuildCategoryIndex() {
+    categoryIndexCount = 0;
+    for (int i = 0; i < recordCount; i++) {
+        CategoryIndexEntry* entry = findCategoryEntry(records[i].category, 1);
+        if (entry != NULL) bitmapSet(&entry->members, i);
+    }
+}
+
+// ============================================================================
+// CATEGORY RUNNING TOTALS
+// ============================================================================
+
+// Look up a category total by case-folded name, optionally adding it
+CategoryTotal* findCategoryTotal(const char* category, int create) {
+    char key[20];
+    toLowerCase(category, key, sizeof(key));
+    unsigned int hash = foldedHash(key);
+    
+    for (int i = 0; i < categoryTotalCount; i++) {
+        if (categoryTotals[i].hash == hash && strcmp(categoryTotals[i].key, key) == 0) return &categoryTotals[i];
+    }
+    if (!create || categoryTotalCount >= MAX_INDEXED_CATEGORIES) return NULL;
+    
+    memset(&categoryDigests[categoryTotalCount], 0, sizeof(PriceDigest));
+    CategoryTotal* total = &categoryTotals[categoryTotalCount++];
+    memset(total, 0, sizeof(CategoryTotal));
+    strcpy(total->key, key);
+    total->hash = hash;
+    strncpy(total->name, category[0] != '\0' ? category : "(none)", sizeof(total->name) - 1);
+    return total;
+}
+
+// Add (direction=1) or remove (direction=-1) one record from its category
+void categoryTotalAdd(const Record* r, int direction) {
+    CategoryTotal* total = findCategoryTotal(r->category, direction > 0);
+    if (total == NULL) return;
+    
+    if (direction > 0) {
+        if (total->count == 0 || r->price < total->min) total->min = r->price;
+        if (total->count == 0 || r->price > total->max) total->max = r->price;
+        total->count++;
+        total->value += r->price;
+        PriceDigest* digest = &categoryDigests[total - categoryTotals];
+        if (!digest->stale) digestAdd(digest, r->price, 1);
+        return;
+    }
+    
+    total->count--;
+    total->value -= r->price;
+    int index = (int)(total - categoryTotals);
+    if (total->count <= 0) {
+        memmove(&categoryTotals[index], &categoryTotals[index + 1],
+                (categoryTotalCount - index - 1) * sizeof(CategoryTotal));
+        memmove(&categoryDigests[index], &categoryDigests[index + 1],
+                (categoryTotalCount - index - 1) * sizeof(PriceDigest));
+        categoryTotalCount--;
+        return;
+    }
+    if (r->price <= total->min || r->price >= total->max) {
+        total->extremesStale = 1;
+    }
+    categoryDigests[index].stale = 1;
+}
+
+// Recompute min/max from the category's member bitmap
+void refreshCategoryExtremes(CategoryTotal* total) {
+    CategoryIndexEntry* entry = findCategoryEntry(total->key, 0);
+    int first = 1;
+    
+    if (entry != NULL) {
+        for (int i = bitmapNext(&entry->members, 0); i >= 0 && i < recordCount; i = bitmapNext(&entry->members, i + 1)) {
+            if (first || records[i].price < total->min) total->min = records[i].price;
+            if (first || records[i].price > total->max) total->max = records[i].price;
+            first = 0;
+        }
+    }
+    total->extremesStale = 0;
+}
+
+void rebuildCategoryTotals() {
+    categoryTotalCount = 0;
+    for (int i = 0; i < recordCount; i++) {
+        categoryTotalAdd(&records[i], 1);
+    }
+}
+
+int compareCategoryTotals(const void* a, const void* b) {
+    return strcmp(((const CategoryTotal*)a)->name, ((const CategoryTotal*)b)->name);
+}
+
+// Category summary for the report, in O(number of categories)
+void writeCategoryTotals(FILE* file) {
+    for (int c = 0; c < categoryTotalCount; c++) {
+        if (categoryTotals[c].extremesStale) refreshCategoryExtremes(&categoryTotals[c]);
+    }
+    writeCategorySummary(file, categoryTotals, categoryTotalCount);
+}
+
+// Summary of a set of totals with fresh extremes (live or a snapshot's)
+void writeCategorySummary(FILE* file, const CategoryTotal* totals, int count) {
+    CategoryTotal sorted[MAX_INDEXED_CATEGORIES];
+    
+    memcpy(sorted, totals, count * sizeof(CategoryTotal));
+    qsort(sorted, count, sizeof(CategoryTotal), compareCategoryTotals);
+    
+    fprintf(file, "\n--------------------------------------------------------------\n");
+    fprintf(file, "                    SUMMARY BY CATEGORY\n");
+    fprintf(file, "--------------------------------------------------------------\n");
+    fprintf(file, "%-36s %6s %14s %11s %11s %11s\n", "Group", "Items", "Total Value", "Min", "Max", "Average");
+    for (int c = 0; c < count; c++) {
+        fprintf(file, "%-36s %6d %14.2f %11.2f %11.2f %11.2f\n",
+                sorted[c].name, sorted[c].count, sorted[c].value,
+                sorted[c].min, sorted[c].max, sorted[c].value / sorted[c].count);
+    }
+}
+
+// ============================================================================
+// PRICE DIGESTS (PERCENTILES)
+// ============================================================================
+int compareCentroids(const void* a, const void* b) {
+    double ma = ((const Centroid*)a)->mean;
+    double mb = ((const Centroid*)b)->mean;
+    return (ma > mb) - (ma < mb);
+}
+
+// Merge the buffered points into the centroids. A centroid may grow to
+// 4 * n * q * (1 - q) / compression, so the tails stay near-exact
+void digestCompress(PriceDigest* digest) {
+    if (digest->bufferCount == 0) return;
+    
+    int count = digest->centroidCount + digest->bufferCount;
+    Centroid* c = digest->centroids;
+    qsort(c, count, sizeof(Centroid), compareCentroids);
+    
+    int merged = 0;
+    double before = 0;       // Weight of the centroids already closed
+    for (int i = 1; i < count; i++) {
+        double combined = c[merged].weight + c[i].weight;
+        double q = (before + combined / 2) / digest->totalWeight;
+        double limit = 4 * digest->totalWeight * q * (1 - q) / DIGEST_COMPRESSION;
+        if (combined <= limit || combined <= 1) {
+            c[merged].mean += (c[i].mean - c[merged].mean) * c[i].weight / combined;
+            c[merged].weight = combined;
+        } else {
+            before += c[merged].weight;
+            c[++merged] = c[i];
+        }
+    }
+    digest->centroidCount = merged + 1;
+    digest->bufferCount = 0;
+    
+    // The size bound keeps this under DIGEST_CENTROIDS; tighten if it ever does not
+    while (digest->centroidCount > DIGEST_CENTROIDS) {
+        int target = 0;
+        for (int i = 1; i < digest->centroidCount; i++) {
+            if (c[i].weight + c[i - 1].weight < c[target].weight + c[target + 1].weight) target = i - 1;
+        }
+        double combined = c[target].weight + c[target + 1].weight;
+        c[target].mean += (c[target + 1].mean - c[target].mean) * c[target + 1].weight / combined;
+        c[target].weight = combined;
+        memmove(&c[target + 1], &c[target + 2], (digest->centroidCount - target - 2) * sizeof(Centroid));
+        digest->centroidCount--;
+    }
+}
+
+void digestAdd(PriceDigest* digest, double price, double weight) {
+    if (digest->totalWeight == 0 || price < digest->min) digest->min = (float)price;
+    if (digest->totalWeight == 0 || price > digest->max) digest->max = (float)price;
+    
+    Centroid* point = &digest->centroids[digest->centroidCount + digest->bufferCount++];
+    point->mean = price;
+    point->weight = weight;
+    digest->totalWeight += weight;
+    if (digest->bufferCount == DIGEST_BUFFER) digestCompress(digest);
+}
+
+// Fold another digest in as weighted points; from is left unchanged
+void digestMerge(PriceDigest* into, PriceDigest* from) {
+    digestCompress(from);
+    for (int i = 0; i < from->centroidCount; i++) {
+        digestAdd(into, from->centroids[i].mean, from->centroids[i].weight);
+    }
+    if (from->totalWeight > 0) {
+        if (from->min < into->min) into->min = from->min;
+        if (from->max > into->max) into->max = from->max;
+    }
+}
+
+// Price at quantile q (0..1), interpolating between centroid centres and
+// towards the exact min/max at the ends
+double digestQuantile(PriceDigest* digest, double q) {
+    digestCompress(digest);
+    int count = digest->centroidCount;
+    Centroid* c = digest->centroids;
+    if (count == 0) return 0;
+    if (count == 1) return c[0].mean;
+    
+    double index = q * digest->totalWeight;
+    if (index < c[0].weight / 2) {
+        return digest->min + (c[0].mean - digest->min) * index / (c[0].weight / 2);
+    }
+    double cumulative = c[0].weight / 2;
+    for (int i = 0; i + 1 < count; i++) {
+        double step = (c[i].weight + c[i + 1].weight) / 2;
+        if (cumulative + step > index) {
+            return c[i].mean + (c[i + 1].mean - c[i].mean) * (index - cumulative) / step;
+        }
+        cumulative += step;
+    }
+    double tail = c[count - 1].weight / 2;
+    double t = tail > 0 ? (index - cumulative) / tail : 1;
+    if (t > 1) t = 1;
+    return c[count - 1].mean + (digest->max - c[count - 1].mean) * t;
+}
+
+// The category's digest, rebuilt from its member bitmap if a removal left it stale
+PriceDigest* categoryDigest(const CategoryTotal* total) {
+    PriceDigest* digest = &categoryDigests[total - categoryTotals];
+    if (!digest->stale) return digest;
+    
+    memset(digest, 0, sizeof(PriceDigest));
+    CategoryIndexEntry* entry = findCategoryEntry(total->key, 0);
+    if (entry != NULL) {
+        for (int i = bitmapNext(&entry->members, 0); i >= 0 && i < recordCount; i = bitmapNext(&entry->members, i + 1)) {
+            digestAdd(digest, records[i].price, 1);
+        }
+    }
+    return digest;
+}
+
+// Percentiles per category for the report, plus all categories merged
+void writePriceDistribution(FILE* file) {
+    for (int c = 0; c < categoryTotalCount; c++) {
+        categoryDigest(&categoryTotals[c]);
+    }
+    writeDigestSummary(file, categoryTotals, categoryDigests, categoryTotalCount, recordCount);
+}
+
+// digests[c] belongs to totals[c] and must not be stale
+void writeDigestSummary(FILE* file, const CategoryTotal* totals, PriceDigest* digests, int count, int itemCount) {
+    static const double quantiles[] = {0.10, 0.25, 0.50, 0.75, 0.90, 0.99};
+    PriceDigest all;
+    int order[MAX_INDEXED_CATEGORIES];
+    
+    // Name order, by insertion: there are at most MAX_INDEXED_CATEGORIES
+    for (int c = 0; c < count; c++) {
+        int pos = c;
+        while (pos > 0 && strcmp(totals[order[pos - 1]].name, totals[c].name) > 0) {
+            order[pos] = order[pos - 1];
+            pos--;
+        }
+        order[pos] = c;
+    }
+    memset(&all, 0, sizeof(all));
+    
+    fprintf(file, "\n--------------------------------------------------------------\n");
+    fprintf(file, "                    PRICE DISTRIBUTION BY CATEGORY\n");
+    fprintf(file, "--------------------------------------------------------------\n");
+    fprintf(file, "%-20s %6s %10s %10s %10s %10s %10s %10s\n", "Group", "Items", "p10", "p25", "Median", "p75", "p90", "p99");
+    for (int c = 0; c < count; c++) {
+        PriceDigest* digest = &digests[order[c]];
+        fprintf(file, "%-20s %6d", totals[order[c]].name, totals[order[c]].count);
+        for (int q = 0; q < 6; q++) {
+            fprintf(file, " %10.2f", digestQuantile(digest, quantiles[q]));
+        }
+        fprintf(file, "\n");
+        digestMerge(&all, digest);
+    }
+    fprintf(file, "%-20s %6d", "ALL", itemCount);
+    for (int q = 0; q < 6; q++) {
+        fprintf(file, " %10.2f", digestQuantile(&all, quantiles[q]));
+    }
+    fprintf(file, "\n");
+}
+
+// ============================================================================
+// PRICE HISTOGRAM
+// ============================================================================
+int priceBucket(float price) {
+    int bucket = (int)(price / PRICE_BUCKET_WIDTH);
+    if (bucket < 0) return 0;
+    if (bucket >= PRICE_BUCKETS) return PRICE_BUCKETS - 1;
+    return bucket;
+}
+
+// Add (direction = 1) or remove (direction = -1) a record's price
+void priceHistogramAdd(const Record* r, int direction) {
+    int bucket = priceBucket(r->price);
+    priceBucketCount[bucket] += direction;
+    priceBucketValue[bucket] += direction * (double)r->price;
+}
+
+void rebuildPriceHistogram() {
+    memset(priceBucketCount, 0, sizeof(priceBucketCount));
+    memset(priceBucketValue, 0, sizeof(priceBucketValue));
+    for (int i = 0; i < recordCount; i++) {
+        priceHistogramAdd(&records[i], 1);
+    }
+}
+
+// ============================================================================
+// CALENDAR ROLLUP
+// ============================================================================
+
+// Grid day (0-based) of a YYYYMMDD key, or -1 outside the calendar
+int calendarDay(int key) {
+    int year = key / 10000 - CALENDAR_FIRST_YEAR;
+    int month = key / 100 % 100;
+    int day = key % 100;
+    if (year < 0 || year >= CALENDAR_YEARS || month < 1 || month > 12 || day < 1 || day > 31) {
+        return -1;
+    }
+    return (year * 12 + month - 1) * 31 + day - 1;
+}
+
+// Add (direction = 1) or remove (direction = -1) a record's price on its date
+void calendarAdd(const Record* r, int direction) {
+    int day = calendarDay(dateToKey(r->date));
+    double value = direction * (double)r->price;
+    if (day < 0) {
+        undatedCount += direction;
+        undatedValue += value;
+        return;
+    }
+    
+    monthCount[day / 31] += direction;
+    monthValue[day / 31] += value;
+    yearCount[day / (12 * 31)] += direction;
+    yearValue[day / (12 * 31)] += value;
+    for (int i = day + 1; i <= CALENDAR_DAYS; i += i & -i) {
+        dayCountTree[i] += direction;
+        dayValueTree[i] += value;
+    }
+}
+
+void rebuildCalendar() {
+    memset(dayCountTree, 0, sizeof(dayCountTree));
+    memset(dayValueTree, 0, sizeof(dayValueTree));
+    memset(monthCount, 0, sizeof(monthCount));
+    memset(monthValue, 0, sizeof(monthValue));
+    memset(yearCount, 0, sizeof(yearCount));
+    memset(yearValue, 0, sizeof(yearValue));
+    undatedCount = 0;
+    undatedValue = 0;
+    for (int i = 0; i < recordCount; i++) {
+        calendarAdd(&records[i], 1);
+    }
+}
+
+// Totals of grid days 0..day (nothing when day < 0)
+void calendarPrefix(int day, int* count, double* value) {
+    *count = 0;
+    *value = 0;
+    if (day >= CALENDAR_DAYS) day = CALENDAR_DAYS - 1;
+    for (int i = day + 1; i > 0; i -= i & -i) {
+        *count += dayCountTree[i];
+        *value += dayValueTree[i];
+    }
+}
+
+// Totals dated from fromKey to toKey inclusive (both valid calendar dates)
+void calendarWindow(int fromKey, int toKey, int* count, double* value) {
+    int beforeCount;
+    double beforeValue;
+    calendarPrefix(calendarDay(toKey), count, value);
+    calendarPrefix(calendarDay(fromKey) - 1, &beforeCount, &beforeValue);
+    *count -= beforeCount;
+    *value -= beforeValue;
+}
+
+// ============================================================================
+// APPROXIMATE AGGREGATES (STRATIFIED SAMPLE)
+// ============================================================================
+
+// Uniform integer in [0, n) from a xorshift64* generator
+int sampleRandom(int n) {
+    sampleRandomState ^= sampleRandomState >> 12;
+    sampleRandomState ^= sampleRandomState << 25;
+    sampleRandomState ^= sampleRandomState >> 27;
+    return (int)(((sampleRandomState * 0x2545F4914F6CDD1DULL) >> 33) % (unsigned long long)n);
+}
+
+void setSampleItem(SampleItem* item, const Record* r) {
+    item->id = r->id;
+    item->price = r->price;
+    item->dateKey = dateToKey(r->date);
+}
+
+// Offer a record that has just joined the sample's category
+void sampleOffer(CategorySample* sample, const Record* r) {
+    sample->population++;
+    
+    int unpaired = sample->removedInside + sample->removedOutside;
+    if (unpaired > 0) {
+        // Take the place of an earlier removal, sampled with the same odds
+        if (sampleRandom(unpaired) < sample->removedInside) {
+            setSampleItem(&sample->items[sample->count++], r);
+            sample->removedInside--;
+        } else {
+            sample->removedOutside--;
+        }
+    } else if (sample->count < SAMPLE_CAPACITY) {
+        setSampleItem(&sample->items[sample->count++], r);
+    } else {
+        int j = sampleRandom(sample->population);
+        if (j < SAMPLE_CAPACITY) setSampleItem(&sample->items[j], r);
+    }
+}
+
+void sampleAdd(const Record* r) {
+    CategoryIndexEntry* entry = findCategoryEntry(r->category, 1);
+    if (entry != NULL) sampleOffer(&categorySamples[entry - categoryIndex], r);
+}
+
+// r is leaving its category
+void sampleRemove(const Record* r) {
+    CategoryIndexEntry* entry = findCategoryEntry(r->category, 0);
+    if (entry == NULL) return;
+    CategorySample* sample = &categorySamples[entry - categoryIndex];
+    
+    if (--sample->population <= 0) {
+        memset(sample, 0, sizeof(CategorySample));
+        return;
+    }
+    for (int i = 0; i < sample->count; i++) {
+        if (sample->items[i].id == r->id) {
+            sample->items[i] = sample->items[--sample->count];
+            sample->removedInside++;
+            return;
+        }
+    }
+    sample->removedOutside++;
+}
+
+// A record changed in place: a sampled record keeps its place unless it moved
+// to another category
+void sampleReplace(const Record* before, const Record* after) {
+    if (strcmp(before->category, after->category) != 0) {
+        sampleRemove(before);
+        sampleAdd(after);
+        return;
+    }
+    
+    CategoryIndexEntry* entry = findCategoryEntry(after->category, 0);
+    if (entry == NULL) return;
+    CategorySample* sample = &categorySamples[entry - categoryIndex];
+    for (int i = 0; i < sample->count; i++) {
+        if (sample->items[i].id == before->id) {
+            setSampleItem(&sample->items[i], after);
+            return;
+        }
+    }
+}
+
+// Draw a fresh reservoir from the category's member bitmap
+void resampleCategory(int index) {
+    const Bitmap* members = &categoryIndex[index].members;
+    CategorySample* sample = &categorySamples[index];
+    
+    memset(sample, 0, sizeof(CategorySample));
+    for (int i = bitmapNext(members, 0); i >= 0 && i < recordCount; i = bitmapNext(members, i + 1)) {
+        sampleOffer(sample, &records[i]);
+    }
+}
+
+void rebuildSamples() {
+    for (int c = 0; c < categoryIndexCount; c++) {
+        resampleCategory(c);
+    }
+}
+
+// Estimated count, total value and average price of the records matching the
+// filter, with 95% margins of error (0 for a category that is fully sampled).
+// category NULL = all; a 0 date key or negative price leaves that end open.
+// Each category is a stratum: its sample is scaled up to its population, and
+// the average is the ratio of the two totals. Returns the items read.
+int approximateAggregate(const char* category, int fromKey, int toKey, float minPrice, float maxPrice,
+                         double estimates[3], double margins[3], int* population) {
+    double count = 0, sum = 0;
+    double varCount = 0, varSum = 0, covariance = 0;
+    int itemsRead = 0;
+    int first = 0, last = categoryIndexCount - 1;
+    
+    *population = 0;
+    if (category != NULL) {
+        CategoryIndexEntry* entry = findCategoryEntry(category, 0);
+        if (entry == NULL) {
+            last = -1;
+        } else {
+            first = last = (int)(entry - categoryIndex);
+        }
+    }
+    
+    for (int c = first; c <= last; c++) {
+        CategorySample* sample = &categorySamples[c];
+        int full = sample->population < SAMPLE_CAPACITY ? sample->population : SAMPLE_CAPACITY;
+        // Redraw a reservoir shrunk below half its size by removals, or one
+        // that could hold its whole category but does not
+        if (sample->count * 2 < full || (sample->population <= SAMPLE_CAPACITY && sample->count < full)) {
+            resampleCategory(c);
+        }
+        if (sample->count == 0) continue;
+        
+        int n = sample->count;
+        double x = 0, y = 0, yy = 0;   // Matches, their prices, squared prices
+        for (int i = 0; i < n; i++) {
+            const SampleItem* item = &sample->items[i];
+            if ((fromKey != 0 && item->dateKey < fromKey) || (toKey != 0 && (item->dateKey > toKey || item->dateKey == 0))) continue;
+            if ((minPrice >= 0 && item->price < minPrice) || (maxPrice >= 0 && item->price > maxPrice)) continue;
+            x += 1;
+            y += item->price;
+            yy += (double)item->price * item->price;
+        }
+        
+        double scale = (double)sample->population / n;
+        count += scale * x;
+        sum += scale * y;
+        *population += sample->population;
+        itemsRead += n;
+        
+        // Variance of a stratum total: N^2 (1 - n/N) s^2 / n
+        if (n > 1 && n < sample->population) {
+            double factor = (double)sample->population * sample->population * (1.0 - (double)n / sample->population) / n;
+            // A match indicator squared is itself, so sum(x^2) = x and sum(xy) = y
+            varCount += factor * (x - x * x / n) / (n - 1);
+            varSum += factor * (yy - y * y / n) / (n - 1);
+            covariance += factor * (y - x * y / n) / (n - 1);
+        }
+    }
+    
+    estimates[0] = count;
+    estimates[1] = sum;
+    estimates[2] = count > 0 ? sum / count : 0;
+    margins[0] = SAMPLE_Z95 * sqrt(varCount > 0 ? varCount : 0);
+    margins[1] = SAMPLE_Z95 * sqrt(varSum > 0 ? varSum : 0);
+    margins[2] = 0;
+    if (count > 0) {
+        // Linearised variance of the ratio sum / count
+        double ratio = estimates[2];
+        double varRatio = (varSum - 2 * ratio * covariance + ratio * ratio * varCount) / (count * count);
+        margins[2] = SAMPLE_Z95 * sqrt(varRatio > 0 ? varRatio : 0);
+    }
+    return itemsRead;
+}
+
+// ============================================================================
+// COLUMN SCAN KERNELS
+// Range filters over the column arrays that set one bitmap bit per matching
+// slot; AVX2 and SSE4.1 versions are chosen at runtime, scalar otherwise
+// ============================================================================
+void setColumns(int slot) {
+    idColumn[slot] = records[slot].id;
+    priceColumn[slot] = records[slot].price;
+    dateKeyColumn[slot] = dateToKey(records[slot].date);
+    toLowerCase(records[slot].productName, nameFoldedColumn[slot], sizeof(nameFoldedColumn[slot]));
+    toLowerCase(records[slot].category, categoryFoldedColumn[slot], sizeof(categoryFoldedColumn[slot]));
+    nameHashColumn[slot] = foldedHash(nameFoldedColumn[slot]);
+    categoryHashColumn[slot] = foldedHash(categoryFoldedColumn[slot]);
+}
+
+// FNV-1a hash of an already case-folded string
+unsigned int foldedHash(const char* folded) {
+    unsigned int h = 2166136261u;
+    for (const char* c = folded; *c != '\0'; c++) {
+        h ^= (unsigned char)*c;
+        h *= 16777619u;
+    }
+    return h;
+}
+
+int detectScanLevel() {
+#if SCAN_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) return SCAN_AVX2;
+    if (__builtin_cpu_supports("sse4.1")) return SCAN_SSE41;
+#endif
+    return SCAN_SCALAR;
+}
+
+const char* scanLevelName() {
+    if (scanLevel < 0) scanLevel = detectScanLevel();
+    if (scanLevel == SCAN_AVX2) return "AVX2";
+    if (scanLevel == SCAN_SSE41) return "SSE4.1";
+    return "scalar";
+}
+
+void scanIntRangeScalar(const int* column, int from, int count, int lo, int hi, Bitmap* out) {
+    for (int i = from; i < count; i++) {
+        if (column[i] >= lo && column[i] <= hi) bitmapSet(out, i);
+    }
+}
+
+void scanFloatRangeScalar(const float* column, int from, int count, float lo, int loInclusive,
+                          float hi, int hiInclusive, Bitmap* out) {
+    for (int i = from; i < count; i++) {
+        float x = column[i];
+        int aboveLo = loInclusive ? (x >= lo) : (x > lo);
+        int belowHi = hiInclusive ? (x <= hi) : (x < hi);
+        if (aboveLo && belowHi) bitmapSet(out, i);
+    }
+}
+
+#if SCAN_X86
+// lo <= x <= hi tested as max(x, lo) == x && min(x, hi) == x (no overflow at the ends)
+__attribute__((target("avx2")))
+void scanIntRangeAVX2(const int* column, int count, int lo, int hi, Bitmap* out) {
+    __m256i low = _mm256_set1_epi32(lo);
+    __m256i high = _mm256_set1_epi32(hi);
+    int i = 0;
+    
+    for (; i + 8 <= count; i += 8) {
+        __m256i x = _mm256_loadu_si256((const __m256i*)&column[i]);
+        __m256i inRange = _mm256_and_si256(_mm256_cmpeq_epi32(_mm256_max_epi32(x, low), x),
+                                           _mm256_cmpeq_epi32(_mm256_min_epi32(x, high), x));
+        unsigned long long mask = (unsigned)_mm256_movemask_ps(_mm256_castsi256_ps(inRange));
+        out->words[i / 64] |= mask << (i % 64);
+    }
+    scanIntRangeScalar(column, i, count, lo, hi, out);
+}
+
+__attribute__((target("sse4.1")))
+void scanIntRangeSSE41(const int* column, int count, int lo, int hi, Bitmap* out) {
+    __m128i low = _mm_set1_epi32(lo);
+    __m128i high = _mm_set1_epi32(hi);
+    int i = 0;
+    
+    for (; i + 4 <= count; i += 4) {
+        __m128i x = _mm_loadu_si128((const __m128i*)&column[i]);
+        __m128i inRange = _mm_and_si128(_mm_cmpeq_epi32(_mm_max_epi32(x, low), x),
+                                        _mm_cmpeq_epi32(_mm_min_epi32(x, high), x));
+        unsigned long long mask = (unsigned)_mm_movemask_ps(_mm_castsi128_ps(inRange));
+        out->words[i / 64] |= mask << (i % 64);
+    }
+    scanIntRangeScalar(column, i, count, lo, hi, out);
+}
+
+__attribute__((target("avx2")))
+void scanFloatRangeAVX2(const float* column, int count, float lo, int loInclusive,
+                        float hi, int hiInclusive, Bitmap* out) {
+    __m256 low = _mm256_set1_ps(lo);
+    __m256 high = _mm256_set1_ps(hi);
+    int i = 0;
+    
+    for (; i + 8 <= count; i += 8) {
+        __m256 x = _mm256_loadu_ps(&column[i]);
+        __m256 aboveLo = loInclusive ? _mm256_cmp_ps(x, low, _CMP_GE_OQ) : _mm256_cmp_ps(x, low, _CMP_GT_OQ);
+        __m256 belowHi = hiInclusive ? _mm256_cmp_ps(x, high, _CMP_LE_OQ) : _mm256_cmp_ps(x, high, _CMP_LT_OQ);
+        unsigned long long mask = (unsigned)_mm256_movemask_ps(_mm256_and_ps(aboveLo, belowHi));
+        out->words[i / 64] |= mask << (i % 64);
+    }
+    scanFloatRangeScalar(column, i, count, lo, loInclusive, hi, hiInclusive, out);
+}
+
+__attribute__((target("sse4.1")))
+void scanFloatRangeSSE41(const float* column, int count, float lo, int loInclusive,
+                         float hi, int hiInclusive, Bitmap* out) {
+    __m128 low = _mm_set1_ps(lo);
+    __m128 high = _mm_set1_ps(hi);
+    int i = 0;
+    
+    for (; i + 4 <= count; i += 4) {
+        __m128 x = _mm_loadu_ps(&column[i]);
+        __m128 aboveLo = loInclusive ? _mm_cmpge_ps(x, low) : _mm_cmpgt_ps(x, low);
+        __m128 belowHi = hiInclusive ? _mm_cmple_ps(x, high) : _mm_cmplt_ps(x, high);
+        unsigned long long mask = (unsigned)_mm_movemask_ps(_mm_and_ps(aboveLo, belowHi));
+        out->words[i / 64] |= mask << (i % 64);
+    }
+    scanFloatRangeScalar(column, i, count, lo, loInclusive, hi, hiInclusive, out);
+}
+#endif
+
+// Bitmap of slots whose column value is in [lo, hi]
+void scanIntRange(const int* column, int count, int lo, int hi, Bitmap* out) {
+    memset(out, 0, sizeof(Bitmap));
+    if (scanLevel < 0) scanLevel = detectScanLevel();
+#if SCAN_X86
+    if (scanLevel == SCAN_AVX2) { scanIntRangeAVX2(column, count, lo, hi, out); return; }
+    if (scanLevel == SCAN_SSE41) { scanIntRangeSSE41(column, count, lo, hi, out); return; }
+#endif
+    scanIntRangeScalar(column, 0, count, lo, hi, out);
+}
+
+// Bitmap of slots whose column value is between lo and hi (each end open or closed)
+void scanFloatRange(const float* column, int count, float lo, int loInclusive, float hi, int hiInclusive, Bitmap* out) {
+    memset(out, 0, sizeof(Bitmap));
+    if (scanLevel < 0) scanLevel = detectScanLevel();
+#if SCAN_X86
+    if (scanLevel == SCAN_AVX2) { scanFloatRangeAVX2(column, count, lo, loInclusive, hi, hiInclusive, out); return; }
+    if (scanLevel == SCAN_SSE41) { scanFloatRangeSSE41(column, count, lo, loInclusive, hi, hiInclusive, out); return; }
+#endif
+    scanFloatRangeScalar(column, 0, count, lo, loInclusive, hi, hiInclusive, out);
+}
+
+// Slot holding a record ID, or -1
+int findSlotByID(int id) {
+    Bitmap hits;
+    if (!bloomMayContain(id)) return -1;
+    scanIntRange(idColumn, recordCount, id, id, &hits);
+    return bitmapNext(&hits, 0);
+}
+
+// ============================================================================
+// NAME TRIES (PREFIX AUTOCOMPLETE)
+// ============================================================================
+TrieNode* trieNewNode(const char* label, int length) {
+    TrieNode* node = calloc(1, sizeof(TrieNode));
+    if (node == NULL) {
+        printf("[ERROR] Out of memory while updating the name trie!\n");
+        exit(1);
+    }
+    node->label = malloc(length + 1);
+    if (node->label == NULL) {
+        printf("[ERROR] Out of memory while updating the name trie!\n");
+        exit(1);
+    }
+    memcpy(node->label, label, length);
+    node->label[length] = '\0';
+    return node;
+}
+
+// Add countDelta records to a name (pin=1 marks it as a catalog name),
+// splitting edges as needed and keeping live counts along the path
+void trieAdjust(TrieNode* root, const char* text, int countDelta, int pin) {
+    char key[MAX_NAME_LENGTH];
+    TrieNode* path[MAX_NAME_LENGTH + 1];
+    int depth = 0;
+    TrieNode* node = root;
+    const char* rest = key;
+    int adding = (countDelta > 0 || pin);
+    
+    toLowerCase(text, key, sizeof(key));
+    if (key[0] == '\0') return;
+    path[depth++] = root;
+    
+    while (*rest != '\0') {
+        TrieNode** link = &node->child;
+        while (*link != NULL && (unsigned char)(*link)->label[0] < (unsigned char)*rest) {
+            link = &(*link)->sibling;
+        }
+        
+        if (*link == NULL || (*link)->label[0] != *rest) {
+            if (!adding) return;  // Name was never added
+            TrieNode* leaf = trieNewNode(rest, (int)strlen(rest));
+            leaf->sibling = *link;
+            *link = leaf;
+        }
+        
+        TrieNode* next = *link;
+        int common = 0;
+        while (next->label[common] != '\0' && next->label[common] == rest[common]) common++;
+        
+        if (next->label[common] != '\0') {
+            if (!adding) return;
+            // Split the edge: a new node takes the shared part of the label
+            TrieNode* middle = trieNewNode(next->label, common);
+            memmove(next->label, next->label + common, strlen(next->label + common) + 1);
+            middle->child = next;
+            middle->sibling = next->sibling;
+            middle->live = next->live;
+            next->sibling = NULL;
+            *link = middle;
+            next = middle;
+        }
+        
+        node = next;
+        path[depth++] = node;
+        rest += common;
+    }
+    
+    int wasLive = (node->count > 0 || node->pinned);
+    if (node->word == NULL) {
+        if (!adding) return;
+        node->word = malloc(strlen(text) + 1);
+        if (node->word == NULL) {
+            printf("[ERROR] Out of memory while updating the name trie!\n");
+            exit(1);
+        }
+        strcpy(node->word, text);
+    }
+    node->count += countDelta;
+    if (node->count < 0) node->count = 0;
+    if (pin) node->pinned = 1;
+    
+    int isLive = (node->count > 0 || node->pinned);
+    if (isLive != wasLive) {
+        for (int d = 0; d < depth; d++) {
+            path[d]->live += isLive - wasLive;
+        }
+    }
+}
+
+// Depth-first walk in label order, stopping after max names
+void trieCollect(const TrieNode* node, const TrieNode** out, int* found, int max) {
+    if (*found >= max || node->live == 0) return;
+    if (node->count > 0 || node->pinned) out[(*found)++] = node;
+    for (const TrieNode* c = node->child; c != NULL && *found < max; c = c->sibling) {
+        trieCollect(c, out, found, max);
+    }
+}
+
+// Up to max live names starting with prefix (case-insensitive), alphabetical
+int trieComplete(const TrieNode* root, const char* prefix, const TrieNode** out, int max) {
+    char key[MAX_NAME_LENGTH];
+    const char* rest = key;
+    const TrieNode* node = root;
+    int found = 0;
+    
+    toLowerCase(prefix, key, sizeof(key));
+    while (*rest != '\0') {
+        const TrieNode* next = node->child;
+        while (next != NULL && next->label[0] != *rest) next = next->sibling;
+        if (next == NULL) return 0;
+        
+        int common = 0;
+        while (next->label[common] != '\0' && next->label[common] == rest[common]) common++;
+        if (next->label[common] != '\0' && rest[common] != '\0') return 0;  // Differs inside the edge
+        
+        node = next;
+        rest += common;
+    }
+    
+    trieCollect(node, out, &found, max);
+    return found;
+}
+
+void trieFree(TrieNode* node) {
+    while (node != NULL) {
+        TrieNode* sibling = node->sibling;
+        trieFree(node->child);
+        free(node->label);
+        free(node->word);
+        free(node);
+        node = sibling;
+    }
+}
+
+void trieClear(TrieNode* root) {
+    trieFree(root->child);
+    memset(root, 0, sizeof(TrieNode));
+}
+
+// Built-in and custom catalog names stay suggestible with no records
+void pinCatalogNames() {
+    for (int i = 0; i < (int)(sizeof(iphones) / sizeof(iphones[0])); i++) trieAdjust(&productTrie, iphones[i], 0, 1);
+    for (int i = 0; i < (int)(sizeof(macbooks) / sizeof(macbooks[0])); i++) trieAdjust(&productTrie, macbooks[i], 0, 1);
+    for (int i = 0; i < (int)(sizeof(iwatch) / sizeof(iwatch[0])); i++) trieAdjust(&productTrie, iwatch[i], 0, 1);
+    trieAdjust(&categoryTrie, "iPhones", 0, 1);
+    trieAdjust(&categoryTrie, "MacBooks", 0, 1);
+    trieAdjust(&categoryTrie, "iWatch", 0, 1);
+    
+    for (int c = 0; c < customCategoryCount; c++) {
+        trieAdjust(&categoryTrie, customCategories[c], 0, 1);
+        for (int i = 0; i < customProductCount[c]; i++) {
+            trieAdjust(&productTrie, customProducts[c][i], 0, 1);
+        }
+    }
+}
+
+void rebuildNameTries() {
+    trieClear(&productTrie);
+    trieClear(&categoryTrie);
+    pinCatalogNames();
+    for (int i = 0; i < recordCount; i++) {
+        trieAdjust(&productTrie, records[i].productName, 1, 0);
+        trieAdjust(&categoryTrie, records[i].category, 1, 0);
+    }
+}
+
+// If text ends with '*', list product names starting with the rest and let
+// the user pick one; otherwise (or if nothing is picked) text is the prefix
+void completeFromSuggestions(char* text, size_t size) {
+    size_t length = strlen(text);
+    const TrieNode* matches[MAX_SUGGESTIONS];
+    char input[20];
+    int choice;
+    
+    if (length == 0 || text[length - 1] != '*') return;
+    text[length - 1] = '\0';
+    
+    int found = trieComplete(&productTrie, text, matches, MAX_SUGGESTIONS);
+    if (found == 0) {
+        printf("[ERROR] No product names start with '%s'.\n", text);
+        return;
+    }
+    
+    printf("\nSuggestions:\n");
+    for (int i = 0; i < found; i++) {
+        printf("  %d. %s\n", i + 1, matches[i]->word);
+    }
+    printf("Select a suggestion (1-%d) or press Enter to use '%s': ", found, text);
+    fflush(stdout);
+    if (fgets(input, sizeof(input), stdin) == NULL) return;
+    if (sscanf(input, "%d", &choice) == 1 && choice >= 1 && choice <= found) {
+        strncpy(text, matches[choice - 1]->word, size - 1);
+        text[size - 1] = '\0';
+    }
+}
+
+// SUGGEST PRODUCT AND CATEGORY NAMES FOR A PREFIX
+void suggestNames() {
+    char prefix[MAX_NAME_LENGTH];
+    const TrieNode* matches[MAX_SUGGESTIONS];
+    
+    printf("\n==============================================================\n");
+    printf("              SUGGEST NAMES                                   \n");
+    printf("==============================================================\n\n");
+    
+    printf("Enter the beginning of a product or category name: ");
+    fflush(stdout);
+    if (fgets(prefix, sizeof(prefix), stdin) == NULL) {
+        printf("[ERROR] Failed to read prefix!\n");
+        return;
+    }
+    prefix[strcspn(prefix, "\n")] = 0;
+    
+    int productFound = trieComplete(&productTrie, prefix, matches, MAX_SUGGESTIONS);
+    printf("\nProducts:\n");
+    if (productFound == 0) printf("  (none)\n");
+    for (int i = 0; i < productFound; i++) {
+        printf("  %-36s %d record(s)\n", matches[i]->word, matches[i]->count);
+    }
+    
+    int categoryFound = trieComplete(&categoryTrie, prefix, matches, MAX_SUGGESTIONS);
+    printf("\nCategories:\n");
+    if (categoryFound == 0) printf("  (none)\n");
+    for (int i = 0; i < categoryFound; i++) {
+        printf("  %-36s %d record(s)\n", matches[i]->word, matches[i]->count);
+    }
+    
+    if (productFound == 0 && categoryFound == 0) {
+        printf("\n[ERROR] No names start with '%s'!\n", prefix);
+    } else {
+        printf("\n[OK] Showing up to %d suggestion(s) per list.\n", MAX_SUGGESTIONS);
+    }
+}
+
+// ============================================================================
+// MODEL INDEX
+// ============================================================================
+
+// First entry whose (category, name) key is >= the given key
+int modelLowerBound(const char* categoryKey, const char* nameKey) {
+    int low = 0, high = modelCount;
+    while (low < high) {
+        int mid = (low + high) / 2;
+        int cmp = strcmp(modelIndex[mid].categoryKey, categoryKey);
+        if (cmp == 0) cmp = strcmp(modelIndex[mid].nameKey, nameKey);
+        if (cmp < 0) low = mid + 1;
+        else high = mid;
+    }
+    return low;
+}
+
+// Add (direction=1) or remove (direction=-1) the unit r stored at slot;
+// a model whose last unit is removed is dropped
+void modelIndexAdd(int slot, const Record* r, int direction) {
+    char categoryKey[20];
+    char nameKey[MAX_NAME_LENGTH];
+    toLowerCase(r->category, categoryKey, sizeof(categoryKey));
+    toLowerCase(r->productName, nameKey, sizeof(nameKey));
+    
+    int pos = modelLowerBound(categoryKey, nameKey);
+    int exists = pos < modelCount &&
+                 strcmp(modelIndex[pos].categoryKey, categoryKey) == 0 &&
+                 strcmp(modelIndex[pos].nameKey, nameKey) == 0;
+    
+    if (direction > 0) {
+        if (!exists) {
+            memmove(&modelIndex[pos + 1], &modelIndex[pos], (modelCount - pos) * sizeof(ModelEntry));
+            modelCount++;
+            ModelEntry* entry = &modelIndex[pos];
+            memset(entry, 0, sizeof(ModelEntry));
+            strcpy(entry->categoryKey, categoryKey);
+            strcpy(entry->nameKey, nameKey);
+            strcpy(entry->category, r->category);
+            strcpy(entry->productName, r->productName);
+        }
+        modelIndex[pos].count++;
+        modelIndex[pos].value += r->price;
+        bitmapSet(&modelIndex[pos].members, slot);
+        return;
+    }
+    
+    if (!exists) return;
+    modelIndex[pos].count--;
+    modelIndex[pos].value -= r->price;
+    bitmapClearBit(&modelIndex[pos].members, slot);
+    if (modelIndex[pos].count <= 0) {
+        memmove(&modelIndex[pos], &modelIndex[pos + 1], (modelCount - pos - 1) * sizeof(ModelEntry));
+        modelCount--;
+    }
+}
+
+void rebuildModelIndex() {
+    modelCount = 0;
+    for (int i = 0; i < recordCount; i++) {
+        modelIndexAdd(i, &records[i], 1);
+    }
+}
+
+// ============================================================================
+// ID BLOOM FILTER
+// ============================================================================
+
+// 64-bit finalizer (splitmix64) so neighbouring IDs spread across counters
+unsigned long long mixID(int id) {
+    unsigned long long x = (unsigned long long)(unsigned int)id + 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+// Double hashing: position i is h1 + i * h2
+void bloomPositions(int id, unsigned int* positions) {
+    unsigned long long h = mixID(id);
+    unsigned int h1 = (unsigned int)h;
+    unsigned int h2 = (unsigned int)(h >> 32) | 1u;
+    for (int i = 0; i < BLOOM_HASHES; i++) {
+        positions[i] = (h1 + (unsigned int)i * h2) % BLOOM_COUNTERS;
+    }
+}
+
+void bloomAdd(int id) {
+    unsigned int positions[BLOOM_HASHES];
+    bloomPositions(id, positions);
+    for (int i = 0; i < BLOOM_HASHES; i++) {
+        if (bloomCounters[positions[i]] < 255) bloomCounters[positions[i]]++;
+    }
+}
+
+// A saturated counter has lost its exact count, so it is never decremented
+void bloomRemove(int id) {
+    unsigned int positions[BLOOM_HASHES];
+    bloomPositions(id, positions);
+    for (int i = 0; i < BLOOM_HASHES; i++) {
+        if (bloomCounters[positions[i]] > 0 && bloomCounters[positions[i]] < 255) bloomCounters[positions[i]]--;
+    }
+}
+
+// 0 means the ID is definitely not stored; 1 means it probably is
+int bloomMayContain(int id) {
+    unsigned int positions[BLOOM_HASHES];
+    bloomPositions(id, positions);
+    for (int i = 0; i < BLOOM_HASHES; i++) {
+        if (bloomCounters[positions[i]] == 0) return 0;
+    }
+    return 1;
+}
+
+void rebuildBloomFilter() {
+    memset(bloomCounters, 0, sizeof(bloomCounters));
+    for (int i = 0; i < recordCount; i++) {
+        bloomAdd(records[i].id);
+    }
+}
+
+// ============================================================================
+// QUERY RESULT CACHE
+// ============================================================================
+
+// Canonical text for a predicate list: one "field op value" term per
+// predicate, sorted, so reordered or re-spaced queries share an entry.
+// Returns 0 if the key would not fit (the query is then not cached).
+int normalizeQuery(const QueryPredicate* predicates, int predicateCount, char* key, size_t size) {
+    static const char* fieldNames[] = {"", "id", "price", "date", "name", "category"};
+    static const char* opNames[] = {"", "=", "<", "<=", ">", ">=", "~"};
+    char terms[MAX_QUERY_PREDICATES][MAX_NAME_LENGTH + 20];
+    size_t used = 0;
+    
+    for (int p = 0; p < predicateCount; p++) {
+        const QueryPredicate* q = &predicates[p];
+        if (q->field == FIELD_NAME || q->field == FIELD_CATEGORY) {
+            snprintf(terms[p], sizeof(terms[p]), "%s%s%s", fieldNames[q->field], opNames[q->op], q->text);
+        } else {
+            snprintf(terms[p], sizeof(terms[p]), "%s%s%.17g", fieldNames[q->field], opNames[q->op], q->number);
+        }
+        for (int j = p; j > 0 && strcmp(terms[j], terms[j - 1]) < 0; j--) {
+            char temp[MAX_NAME_LENGTH + 20];
+            strcpy(temp, terms[j]);
+            strcpy(terms[j], terms[j - 1]);
+            strcpy(terms[j - 1], temp);
+        }
+    }
+    
+    key[0] = '\0';
+    for (int p = 0; p < predicateCount; p++) {
+        int written = snprintf(key + used, size - used, "%s%s", p > 0 ? " AND " : "", terms[p]);
+        if (written < 0 || (size_t)written >= size - used) return 0;
+        used += written;
+    }
+    return 1;
+}
+
+// Cached result for key, or NULL if absent or stored before the last change
+const Bitmap* queryCacheLookup(const char* key) {
+    for (int e = 0; e < QUERY_CACHE_SIZE; e++) {
+        if (queryCache[e].generation == dataGeneration && strcmp(queryCache[e].key, key) == 0) {
+            queryCache[e].lastUsed = ++queryCacheClock;
+            return &queryCache[e].result;
+        }
+    }
+    return NULL;
+}
+
+// Store a result, reusing a stale entry or else evicting the least recently used
+void queryCacheStore(const char* key, const Bitmap* result) {
+    int victim = 0;
+    for (int e = 0; e < QUERY_CACHE_SIZE; e++) {
+        if (queryCache[e].generation != dataGeneration) {
+            victim = e;
+            break;
+        }
+        if (queryCache[e].lastUsed < queryCache[victim].lastUsed) victim = e;
+    }
+    strncpy(queryCache[victim].key, key, QUERY_KEY_LENGTH - 1);
+    queryCache[victim].key[QUERY_KEY_LENGTH - 1] = '\0';
+    queryCache[victim].generation = dataGeneration;
+    queryCache[victim].lastUsed = ++queryCacheClock;
+    queryCache[victim].result = *result;
+}
+
+// ============================================================================
+// TABLE ROW FORMATTING
+// ============================================================================
+
+// Left-aligned text padded with spaces to width (never truncated, like %-Ns)
+size_t appendPaddedText(char* out, const char* text, int width) {
+    size_t length = strlen(text);
+    memcpy(out, text, length);
+    while ((int)length < width) out[length++] = ' ';
+    return length;
+}
+
+// Same output as %-Nd
+size_t appendPaddedInt(char* out, long value, int width) {
+    char digits[24];
+    int count = 0;
+    unsigned long magnitude = value < 0 ? 0UL - (unsigned long)value : (unsigned long)value;
+    do {
+        digits[count++] = (char)('0' + magnitude % 10);
+        magnitude /= 10;
+    } while (magnitude > 0);
+    
+    size_t length = 0;
+    if (value < 0) out[length++] = '-';
+    while (count > 0) out[length++] = digits[--count];
+    while ((int)length < width) out[length++] = ' ';
+    return length;
+}
+
+// Same output as %-N.2f: a float times 100 is exact in a double, so any value
+// that is not exactly half a cent rounds the same in every C library. Exact
+// ties go to printf, since libraries differ on them (glibc rounds to even,
+// msvcrt away from zero), and so does zero, which may carry a sign
+size_t appendPaddedMoney(char* out, float value, int width) {
+    double scaled = (double)value * 100.0;
+    double magnitude = scaled < 0 ? -scaled : scaled;
+    if (!(magnitude < 1e17) || magnitude == 0 || magnitude - (double)(long long)magnitude == 0.5) {
+        int length = snprintf(out, 48, "%-*.2f", width, value);     // Float range: at most 47 characters
+        return length < 48 ? (size_t)length : 47;
+    }
+    
+    size_t length = 0;
+    if (scaled < 0) {
+        out[length++] = '-';
+        scaled = -scaled;
+    }
+    long long cents = (long long)scaled;
+    double fraction = scaled - (double)cents;
+    if (fraction > 0.5) cents++;
+    
+    char digits[24];
+    int count = 0;
+    long long whole = cents / 100;
+    do {
+        digits[count++] = (char)('0' + whole % 10);
+        whole /= 10;
+    } while (whole > 0);
+    while (count > 0) out[length++] = digits[--count];
+    out[length++] = '.';
+    out[length++] = (char)('0' + (cents / 10) % 10);
+    out[length++] = (char)('0' + cents % 10);
+    while ((int)length < width) out[length++] = ' ';
+    return length;
+}
+
+// "| %-10d | %-36s | $%-9.2f | %-10s | %-10s |\n" without printf; returns the length
+size_t formatRecordRow(char* out, const Record* r) {
+    size_t length = 0;
+    out[length++] = '|';
+    out[length++] = ' ';
+    length += appendPaddedInt(out + length, r->id, 10);
+    length += appendPaddedText(out + length, " | ", 0);
+    length += appendPaddedText(out + length, r->productName, 36);
+    length += appendPaddedText(out + length, " | $", 0);
+    length += appendPaddedMoney(out + length, r->price, 9);
+    length += appendPaddedText(out + length, " | ", 0);
+    length += appendPaddedText(out + length, r->date, 10);
+    length += appendPaddedText(out + length, " | ", 0);
+    length += appendPaddedText(out + length, r->category, 10);
+    length += appendPaddedText(out + length, " |\n", 0);
+    return length;
+}
+
+// Room for length more bytes at the end of the buffer (flushing it if needed)
+char* reserveOutput(size_t length) {
+    if (ROW_BUFFER_SIZE - rowBufferLength < length) flushRows();
+    return rowBuffer + rowBufferLength;
+}
+
+char* reserveRow() {
+    return reserveOutput(TABLE_ROW_LENGTH);
+}
+
+void printRecordRow(const Record* r) {
+    char* out = reserveRow();
+    rowBufferLength += formatRecordRow(out, r);
+}
+
+// Must be called before anything else is printed after a run of rows
+void flushRows() {
+    if (rowBufferLength > 0) {
+        fwrite(rowBuffer, 1, rowBufferLength, rowOutput != NULL ? rowOutput : stdout);
+        rowBufferLength = 0;
+    }
+}
+
+// Send later rows to file (NULL = stdout), flushing what is already buffered
+void setRowOutput(FILE* file) {
+    flushRows();
+    rowOutput = file;
+}
+
+// ============================================================================
+// GROUP-BY ENGINE
+// ============================================================================
+unsigned int groupHash(const char* key) {
+    unsigned int h = 2166136261u;
+    for (const char* c = key; *c != '\0'; c++) {
+        h ^= (unsigned char)*c;
+        h *= 16777619u;
+    }
+    return h;
+}
+
+// Group label and match key for a record, and its numeric rank for ordering
+// (0 = by key). Names group case-insensitively, like the other indexes
+long groupKeyFor(const Record* r, int groupBy, char* key, char* label, size_t size) {
+    long rank = 0;
+    
+    if (groupBy == GROUP_BY_CATEGORY) {
+        snprintf(label, size, "%s", r->category[0] != '\0' ? r->category : "(none)");
+    } else if (groupBy == GROUP_BY_PRODUCT) {
+        snprintf(label, size, "%s [%s]", r->productName, r->category);
+    } else if (groupBy == GROUP_BY_MONTH) {
+        int dateKey = dateToKey(r->date);
+        if (dateKey == 0) {
+            snprintf(label, size, "Unknown");
+        } else {
+            snprintf(label, size, "%04d-%02d", dateKey / 10000, dateKey / 100 % 100);
+            rank = dateKey / 100;
+        }
+    } else {
+        int band = (int)(r->price / REPORT_PRICE_BAND);
+        snprintf(label, size, "$%d - $%d", band * REPORT_PRICE_BAND, (band + 1) * REPORT_PRICE_BAND);
+        rank = band + 1;
+    }
+    
+    toLowerCase(label, key, size);
+    return rank;
+}
+
+// Slot count that keeps a table built from rows records at most half full
+// (each record adds at most one group)
+unsigned int groupSlotsFor(int rows) {
+    unsigned int slots = GROUP_TABLE_MIN_SIZE;
+    while (slots < GROUP_TABLE_SIZE && slots <= 2 * (unsigned int)rows) slots <<= 1;
+    return slots;
+}
+
+// slotCount must be a power of two
+void groupTableInit(GroupTable* table, GroupAggregate* slots, unsigned int slotCount) {
+    table->slots = slots;
+    table->mask = slotCount - 1;
+    groupTableReset(table);
+}
+
+void groupTableReset(GroupTable* table) {
+    memset(table->slots, 0, ((size_t)table->mask + 1) * sizeof(GroupAggregate));
+    table->groupCount = 0;
+}
+
+// Aggregate for key, creating an empty one (shown as label) if needed
+GroupAggregate* groupFind(GroupTable* table, const char* key, const char* label, long rank) {
+    unsigned int pos = groupHash(key) & table->mask;
+    while (table->slots[pos].used) {
+        if (strcmp(table->slots[pos].key, key) == 0) return &table->slots[pos];
+        pos = (pos + 1) & table->mask;
+    }
+    GroupAggregate* group = &table->slots[pos];
+    strcpy(group->key, key);
+    strcpy(group->label, label);
+    group->used = 1;
+    group->rank = rank;
+    table->groupCount++;
+    return group;
+}
+
+// One pass over records[] fills tables[g] for each requested grouping g
+void groupByRecords(GroupTable* tables, const int* groupBys, int count) {
+    for (int k = 0; k < count; k++) {
+        groupTableReset(&tables[groupBys[k]]);
+    }
+    groupByRange(tables, groupBys, count, records, 0, recordCount);
+}
+
+// Add source[from..to) (records[] or a snapshot copy) to already initialised tables
+void groupByRange(GroupTable* tables, const int* groupBys, int count, const Record* source, int from, int to) {
+    char key[GROUP_KEY_LENGTH];
+    char label[GROUP_KEY_LENGTH];
+    
+    for (int i = from; i < to; i++) {
+        const Record* r = &source[i];
+        for (int k = 0; k < count; k++) {
+            int g = groupBys[k];
+            long rank = groupKeyFor(r, g, key, label, sizeof(key));
+            GroupAggregate* group = groupFind(&tables[g], key, label, rank);
+            if (group->count == 0 || r->price < group->min) group->min = r->price;
+            if (group->count == 0 || r->price > group->max) group->max = r->price;
+            group->count++;
+            group->sum += r->price;
+        }
+    }
+}
+
+// Fold one table's groups into another
+void groupMerge(GroupTable* into, const GroupTable* from) {
+    for (unsigned int s = 0; s <= from->mask; s++) {
+        const GroupAggregate* part = &from->slots[s];
+        if (!part->used) continue;
+        
+        GroupAggregate* group = groupFind(into, part->key, part->label, part->rank);
+        if (group->count == 0 || part->min < group->min) group->min = part->min;
+        if (group->count == 0 || part->max > group->max) group->max = part->max;
+        group->count += part->count;
+        group->sum += part->sum;
+    }
+}
+
+int compareGroups(const void* a, const void* b) {
+    const GroupAggregate* x = *(const GroupAggregate* const*)a;
+    const GroupAggregate* y = *(const GroupAggregate* const*)b;
+    if (x->rank != y->rank) return (x->rank < y->rank) ? -1 : 1;
+    int cmp = strcmp(x->key, y->key);
+    return cmp != 0 ? cmp : strcmp(x->label, y->label);
+}
+
+// Used groups of a table in report order; returns how many
+int sortedGroups(GroupTable* table, GroupAggregate** out) {
+    int count = 0;
+    for (unsigned int s = 0; s <= table->mask; s++) {
+        if (table->slots[s].used) out[count++] = &table->slots[s];
+    }
+    qsort(out, count, sizeof(GroupAggregate*), compareGroups);
+    return count;
+}
+
+void writeGroupSummary(FILE* file, const char* title, GroupTable* table) {
+    GroupAggregate* groups[MAX_RECORDS];
+    int count = sortedGroups(table, groups);
+    
+    fprintf(file, "\n--------------------------------------------------------------\n");
+    fprintf(file, "                    SUMMARY BY %s\n", title);
+    fprintf(file, "--------------------------------------------------------------\n");
+    fprintf(file, "%-36s %6s %14s %11s %11s %11s\n", "Group", "Items", "Total Value", "Min", "Max", "Average");
+    for (int g = 0; g < count; g++) {
+        fprintf(file, "%-36s %6d %14.2f %11.2f %11.2f %11.2f\n",
+                groups[g]->label, groups[g]->count, groups[g]->sum,
+                groups[g]->min, groups[g]->max, groups[g]->sum / groups[g]->count);
+    }
+}
+
+// ============================================================================
+// PARALLEL REPORT ROWS
+// ============================================================================
+
+// Format one partition's table rows and aggregate them into its own tables
+void formatReportPartition(ReportPartition* partition) {
+    size_t length = 0;
+    
+    for (int i = partition->from; i < partition->to; i++) {
+        length += formatRecordRow(partition->buffer + length, &records[i]);
+    }
+    partition->length = length;
+    groupByRange(partition->groups, partition->groupBys, partition->groupCount, records, partition->from, partition->to);
+}
+
+DWORD WINAPI reportWorkerMain(LPVOID arg) {
+    ReportWorker* worker = (ReportWorker*)arg;
+    for (int p = worker->first; p < REPORT_PARTITIONS; p += worker->stride) {
+        formatReportPartition(&worker->partitions[p]);
+    }
+    return 0;
+}
+
+// Threads to use for the current store: one per core, up to one per partition
+int reportThreadCount() {
+    SYSTEM_INFO info;
+    
+    if (recordCount < REPORT_MIN_PARALLEL_ROWS) return 1;
+    GetSystemInfo(&info);
+    if (info.dwNumberOfProcessors < 1) return 1;
+    if (info.dwNumberOfProcessors > REPORT_PARTITIONS) return REPORT_PARTITIONS;
+    return (int)info.dwNumberOfProcessors;
+}
+
+// Write every record row and fill reportGroups for the given groupings.
+// Partitions are formatted and aggregated by worker threads, then written
+// and merged in partition order. Returns the number of threads used.
+int writeReportRows(FILE* file, const int* groupBys, int groupCount) {
+    ReportPartition partitions[REPORT_PARTITIONS];
+    ReportWorker workers[REPORT_PARTITIONS];
+    HANDLE threads[REPORT_PARTITIONS];
+    int threadCount = reportThreadCount();
+    
+    for (int p = 0; p < REPORT_PARTITIONS; p++) {
+        ReportPartition* partition = &partitions[p];
+        partition->from = (int)((long)recordCount * p / REPORT_PARTITIONS);
+        partition->to = (int)((long)recordCount * (p + 1) / REPORT_PARTITIONS);
+        partition->groupBys = groupBys;
+        partition->groupCount = groupCount;
+        partition->length = 0;
+        partition->buffer = malloc((size_t)(partition->to - partition->from) * REPORT_ROW_LENGTH + 1);
+        
+        unsigned int slotCount = groupSlotsFor(partition->to - partition->from);
+        partition->groupSlots = malloc((size_t)groupCount * slotCount * sizeof(GroupAggregate));
+        if (partition->buffer == NULL || partition->groupSlots == NULL) {
+            printf("[ERROR] Out of memory while building the report!\n");
+            exit(1);
+        }
+        for (int k = 0; k < groupCount; k++) {
+            groupTableInit(&partition->groups[groupBys[k]], partition->groupSlots + (size_t)k * slotCount, slotCount);
+        }
+    }
+    
+    // Worker 0 runs on this thread; if a thread cannot start, its share
+    // falls back to here as well
+    for (int w = 0; w < threadCount; w++) {
+        workers[w].partitions = partitions;
+        workers[w].first = w;
+        workers[w].stride = threadCount;
+        threads[w] = NULL;
+    }
+    for (int w = 1; w < threadCount; w++) {
+        threads[w] = CreateThread(NULL, 0, reportWorkerMain, &workers[w], 0, NULL);
+    }
+    reportWorkerMain(&workers[0]);
+    for (int w = 1; w < threadCount; w++) {
+        if (threads[w] != NULL) {
+            WaitForSingleObject(threads[w], INFINITE);
+            CloseHandle(threads[w]);
+        } else {
+            reportWorkerMain(&workers[w]);
+        }
+    }
+    
+    for (int k = 0; k < groupCount; k++) {
+        groupTableInit(&reportGroups[groupBys[k]], reportGroupSlots[groupBys[k]], GROUP_TABLE_SIZE);
+    }
+    for (int p = 0; p < REPORT_PARTITIONS; p++) {
+        fwrite(partitions[p].buffer, 1, partitions[p].length, file);
+        for (int k = 0; k < groupCount; k++) {
+            groupMerge(&reportGroups[groupBys[k]], &partitions[p].groups[groupBys[k]]);
+        }
+        free(partitions[p].buffer);
+        free(partitions[p].groupSlots);
+    }
+    return threadCount;
+}
+
+// ============================================================================
+// INDEX MAINTENANCE
+// Every change to records[] goes through these so secondary structures stay
+// in step with the base array
+// ============================================================================
+
+// records[slot] has just been appended
+void indexInsertRecord(int slot) {
+    dataGeneration++;
+    bloomAdd(records[slot].id);
+    modelIndexAdd(slot, &records[slot], 1);
+    categoryTotalAdd(&records[slot], 1);
+    setColumns(slot);
+    trieAdjust(&productTrie, records[slot].productName, 1, 0);
+    trieAdjust(&categoryTrie, records[slot].category, 1, 0);
+    
+    for (int v = 0; v < VIEW_COUNT; v++) {
+        viewInsertSlot(&views[v], slot);
+    }
+    trigramIndexName(slot, records[slot].productName, 1);
+    
+    CategoryIndexEntry* entry = findCategoryEntry(records[slot].category, 1);
+    if (entry != NULL) bitmapSet(&entry->members, slot);
+    
+    priceHistogramAdd(&records[slot], 1);
+    calendarAdd(&records[slot], 1);
+    sampleAdd(&records[slot]);
+}
+
+// records[slot] is about to be removed; later slots will shift down by one
+void indexDeleteRecord(int slot) {
+    dataGeneration++;
+    bloomRemove(records[slot].id);
+    int tail = recordCount - slot - 1;
+    memmove(&idColumn[slot], &idColumn[slot + 1], tail * sizeof(int));
+    memmove(&priceColumn[slot], &priceColumn[slot + 1], tail * sizeof(float));
+    memmove(&dateKeyColumn[slot], &dateKeyColumn[slot + 1], tail * sizeof(int));
+    memmove(nameFoldedColumn[slot], nameFoldedColumn[slot + 1], tail * sizeof(nameFoldedColumn[0]));
+    memmove(categoryFoldedColumn[slot], categoryFoldedColumn[slot + 1], tail * sizeof(categoryFoldedColumn[0]));
+    memmove(&nameHashColumn[slot], &nameHashColumn[slot + 1], tail * sizeof(unsigned int));
+    memmove(&categoryHashColumn[slot], &categoryHashColumn[slot + 1], tail * sizeof(unsigned int));
+    trieAdjust(&productTrie, records[slot].productName, -1, 0);
+    trieAdjust(&categoryTrie, records[slot].category, -1, 0);
+    
+    for (int v = 0; v < VIEW_COUNT; v++) {
+        viewRemoveSlot(&views[v], slot);
+        for (int i = 0; i < views[v].count; i++) {
+            if (views[v].order[i] > slot) views[v].order[i]--;
+        }
+    }
+    
+    trigramIndexName(slot, records[slot].productName, 0);
+    for (int b = 0; b < TRIGRAM_BUCKETS; b++) {
+        PostingList* list = &trigramIndex[b];
+        // Lists are sorted, so only the tail past slot needs renumbering
+        for (int i = postingLowerBound(list, slot); i < list->count; i++) {
+            list->slots[i]--;
+        }
+    }
+    
+    for (int c = 0; c < categoryIndexCount; c++) {
+        bitmapRemoveSlot(&categoryIndex[c].members, slot);
+    }
+    
+    modelIndexAdd(slot, &records[slot], -1);
+    categoryTotalAdd(&records[slot], -1);
+    for (int m = 0; m < modelCount; m++) {
+        bitmapRemoveSlot(&modelIndex[m].members, slot);
+    }
+    
+    priceHistogramAdd(&records[slot], -1);
+    calendarAdd(&records[slot], -1);
+    sampleRemove(&records[slot]);
+    dropEmptyCategory(records[slot].category);
+}
+
+// records[slot] has been changed in place; before holds its previous contents
+void indexUpdateRecord(int slot, const Record* before) {
+    dataGeneration++;
+    Record after = records[slot];
+    
+    if (before->id != after.id) {
+        bloomRemove(before->id);
+        bloomAdd(after.id);
+    }
+    
+    setColumns(slot);
+    
+    // Views locate entries by key, so remove using the old values
+    records[slot] = *before;
+    for (int v = 0; v < VIEW_COUNT; v++) {
+        viewRemoveSlot(&views[v], slot);
+    }
+    records[slot] = after;
+    for (int v = 0; v < VIEW_COUNT; v++) {
+        viewInsertSlot(&views[v], slot);
+    }
+    
+    if (strcmp(before->productName, after.productName) != 0) {
+        trigramIndexName(slot, before->productName, 0);
+        trigramIndexName(slot, after.productName, 1);
+        trieAdjust(&productTrie, before->productName, -1, 0);
+        trieAdjust(&productTrie, after.productName, 1, 0);
+    }
+    
+    if (strcmp(before->category, after.category) != 0) {
+        trieAdjust(&categoryTrie, before->category, -1, 0);
+        trieAdjust(&categoryTrie, after.category, 1, 0);
+        CategoryIndexEntry* entry = findCategoryEntry(before->category, 0);
+        if (entry != NULL) bitmapClearBit(&entry->members, slot);
+        entry = findCategoryEntry(after.category, 1);
+        if (entry != NULL) bitmapSet(&entry->members, slot);
+    }
+    
+    modelIndexAdd(slot, before, -1);
+    modelIndexAdd(slot, &after, 1);
+    
+    if (before->price != after.price || strcmp(before->category, after.category) != 0) {
+        categoryTotalAdd(before, -1);
+        categoryTotalAdd(&after, 1);
+    }
+    
+    priceHistogramAdd(before, -1);
+    priceHistogramAdd(&after, 1);
+    
+    if (before->price != after.price || strcmp(before->date, after.date) != 0) {
+        calendarAdd(before, -1);
+        calendarAdd(&after, 1);
+    }
+    
+    sampleReplace(before, &after);
+    if (strcmp(before->category, after.category) != 0) {
+        dropEmptyCategory(before->category);
+    }
+}
+
+// Full rebuild after a load or an in-place reorder of records[]
+void rebuildIndexes() {
+    dataGeneration++;
+    for (int i = 0; i < recordCount; i++) {
+        setColumns(i);
+    }
+    rebuildViews();
+    rebuildTrigramIndex();
+    rebuildCategoryIndex();
+    rebuildPriceHistogram();
+    rebuildCalendar();
+    rebuildSamples();
+    rebuildNameTries();
+    rebuildModelIndex();
+}
+
+// ============================================================================
+// CORE OPERATIONS
+// ============================================================================
+
+// 1. INSERT NEW RECORD
+void insertRecord() {
+    Record newRecord;
+    int categoryChoice;
+    int productChoice;
+    int itemsToAdd;
+    
+    while (1) {
+        printf("\n==============================================================\n");
+        printf("              INSERT NEW RECORD                               \n");
+        printf("==============================================================\n\n");
+    
+    // Check if array is full
+    if (recordCount >= MAX_RECORDS) {
+            printf("[ERROR] Maximum records limit reached (%d)!\n", MAX_RECORDS);
+            printf("Press Enter to continue...");
+            fflush(stdout);
+            getchar();
+        return;
+    }
+    
+        // Display category menu
+        displayCategoryMenu();
+        categoryChoice = getCategoryChoice();
+        
+        if (categoryChoice == -1) {
+            return;  // User chose to go back
+        }
+        if (categoryChoice == -2) {
+            // Create new category
+            createCategoryInteractive();
+            continue; // show category menu again
+        }
+        
+        // Display product submenu for selected category
+        displayProductSubmenu(categoryChoice);
+        productChoice = getProductChoice(categoryChoice);
+        
+        if (productChoice == -1) {
+            continue;  // Go back to category menu
+        }
+        
+        // Get quantity to add (1-5)
+        printf("Enter quantity to add (1-5): ");
+        fflush(stdout);
+        if (scanf("%d", &itemsToAdd) != 1) {
+        clearInputBuffer();
+            printf("[ERROR] Invalid quantity format!\n");
+            printf("Press Enter to continue...");
+            fflush(stdout);
+            getchar();
+            continue;
+        }
+        
+        if (itemsToAdd < 1 || itemsToAdd > 5) {
+            printf("[ERROR] Quantity must be between 1 and 5!\n");
+            printf("Press Enter to continue...");
+            fflush(stdout);
+            getchar();
+            continue;
+        }
+        
+    clearInputBuffer();
+        
+        // Set product name and category (common for all items)
+        if (categoryChoice == 1) {
+            strcpy(newRecord.productName, iphones[productChoice - 1]);
+            strcpy(newRecord.category, "iPhones");
+        } else if (categoryChoice == 2) {
+            strcpy(newRecord.productName, macbooks[productChoice - 1]);
+            strcpy(newRecord.category, "MacBooks");
+        } else if (categoryChoice == 3) {
+            strcpy(newRecord.productName, iwatch[productChoice - 1]);
+            strcpy(newRecord.category, "iWatch");
+        } else {
+            // Custom category
+            int customIndex = categoryChoice - 4;
+            if (customIndex >= 0 && customIndex < customCategoryCount) {
+                if (customProductCount[customIndex] > 0) {
+                    // user selected a listed product
+                    strcpy(newRecord.productName, customProducts[customIndex][productChoice - 1]);
+                } else {
+                    // No predefined products - prompt for product name
+                    char pname[MAX_NAME_LENGTH];
+                    printf("Enter Product Name (end with * for suggestions): ");
+                    fflush(stdout);
+                    if (fgets(pname, sizeof(pname), stdin) == NULL) {
+                        pname[0] = '\0';
+                    }
+                    pname[strcspn(pname, "\n")] = 0;
+                    completeFromSuggestions(pname, sizeof(pname));
+                    if (strlen(pname) == 0) {
+                        printf("[ERROR] Product name cannot be empty!\n");
+                        continue;
+                    }
+                    strncpy(newRecord.productName, pname, MAX_NAME_LENGTH - 1);
+                    newRecord.productName[MAX_NAME_LENGTH - 1] = '\0';
+                }
+                strncpy(newRecord.category, customCategories[customIndex], 19);
+                newRecord.category[19] = '\0';
+            } else {
+                printf("[ERROR] Invalid category selected!\n");
+                continue;
+            }
+        }
+        
+        // Get Price (common for all items)
+        printf("Enter Price ($): ");
+        fflush(stdout);
+        if (scanf("%f", &newRecord.price) != 1) {
+            clearInputBuffer();
             printf("[ERROR] Invalid price format!\n");
             printf("Press Enter to continue...");
             fflush(stdout);
@@ -802,133 +3333,1635 @@ void insertRecord() {
             continue;
         }
         
-        if (!validatePrice(newRecord.price)) {
-            printf("Press Enter to continue...");
-            fflush(stdout);
-            getchar();
-            continue;
+        if (!validatePrice(newRecord.price)) {
+            printf("Press Enter to continue...");
+            fflush(stdout);
+            getchar();
+            continue;
+        }
+        
+        // Get Date (common for all items)
+        clearInputBuffer();
+        printf("Enter Date (DD/MM/YYYY): ");
+        fflush(stdout);
+        if (fgets(newRecord.date, MAX_DATE_LENGTH, stdin) == NULL) {
+            printf("[ERROR] Failed to read date!\n");
+            printf("Press Enter to continue...");
+            fflush(stdout);
+            getchar();
+            continue;
+    }
+    
+    // Remove newline character
+        newRecord.date[strcspn(newRecord.date, "\n")] = 0;
+        
+        // Validate date format and values
+        if (!validateDate(newRecord.date)) {
+            printf("Press Enter to continue...");
+            fflush(stdout);
+            getchar();
+            continue;
+        }
+        
+        // Generate unique ID based on category
+        int nextID = generateNextID(categoryChoice);
+        if (nextID == -1) {
+            printf("[ERROR] Invalid category for ID generation!\n");
+            printf("Press Enter to continue...");
+            fflush(stdout);
+            getchar();
+            continue;
+        }
+        
+        // Add items based on quantity - auto-generate unique IDs for each item
+        for (int item = 0; item < itemsToAdd; item++) {
+            printf("\n--- Adding Item %d of %d ---\n", item + 1, itemsToAdd);
+            
+            // Auto-generate unique ID
+            newRecord.id = nextID + item;
+            
+            // Verify the generated ID is unique (in case of gaps)
+            while (!validateID(newRecord.id)) {
+                newRecord.id++;
+            }
+            
+            // Update nextID for next iteration
+            nextID = newRecord.id + 1;
+    
+            // Add record to array
+            records[recordCount] = newRecord;
+            recordCount++;
+            indexInsertRecord(recordCount - 1);
+            
+            printf("[OK] Item %d added successfully! (ID: %d)\n", item + 1, newRecord.id);
+        }
+    
+    // Save to file
+    saveToFile();
+    
+        printf("\n[OK] All %d record(s) inserted successfully!\n", itemsToAdd);
+        
+        // Ask if user wants to add more
+        printf("\nPress Enter to return to main menu, or type 'B' to add more items: ");
+        fflush(stdout);
+        char response[10];
+        if (fgets(response, sizeof(response), stdin) != NULL) {
+            response[strcspn(response, "\n")] = 0;
+            if (response[0] != 'B' && response[0] != 'b') {
+                break;  // Return to main menu
+            }
+        } else {
+            break;
+        }
+    }
+}
+
+// 2. DISPLAY ALL RECORDS
+void displayAllRecords() {
+    displayRecordsInView(VIEW_STORED, 0);
+}
+
+// Let the user pick an ordering; sorted views are read as-is, nothing is re-sorted
+void displayRecordsMenu() {
+    int choice;
+    
+    while (1) {
+        printf("\n==============================================================\n");
+        printf("                    DISPLAY RECORDS                           \n");
+        printf("--------------------------------------------------------------\n");
+        printf("  1. Stored Order                                            \n");
+        printf("  2. By Price (Lowest to Highest)                            \n");
+        printf("  3. By Price (Highest to Lowest)                            \n");
+        printf("  4. By Date (Oldest to Newest)                              \n");
+        printf("  5. By Date (Newest to Oldest)                              \n");
+        printf("  6. Back to Main Menu                                       \n");
+        printf("==============================================================\n");
+        printCenteredNoNL("Enter your choice (1-6): ");
+        fflush(stdout);
+        
+        if (scanf("%d", &choice) != 1) {
+            clearInputBuffer();
+            printf("[ERROR] Invalid input! Please enter a number.\n");
+            continue;
+        }
+        
+        clearInputBuffer();
+        
+        switch(choice) {
+            case 1:
+                displayRecordsInView(VIEW_STORED, 0);
+                return;
+            case 2:
+                displayRecordsInView(VIEW_PRICE, 0);
+                return;
+            case 3:
+                displayRecordsInView(VIEW_PRICE, 1);
+                return;
+            case 4:
+                displayRecordsInView(VIEW_DATE, 0);
+                return;
+            case 5:
+                displayRecordsInView(VIEW_DATE, 1);
+                return;
+            case 6:
+                return;  // Back to main menu
+            default:
+                printf("[ERROR] Invalid choice! Please select 1-6.\n");
+        }
+    }
+}
+
+// Print records in stored order (VIEW_STORED) or through a sorted view
+void displayRecordsInView(int viewId, int descending) {
+    printf("\n==============================================================\n");
+    printf("              ALL RECORDS                                     \n");
+    printf("==============================================================\n\n");
+    
+    if (recordCount == 0) {
+        printf("No records found in the system.\n");
+        return;
+    }
+    
+    if (viewId != VIEW_STORED) {
+        printf("Order: %s (%s)\n\n", views[viewId].name, descending ? "Descending" : "Ascending");
+    }
+    
+    // Display table header
+    printf("+------------+--------------------------------------+------------+------------+------------+\n");
+    printf("| Product ID | Product Name                         | Price      | Date       | Category   |\n");
+    printf("+------------+--------------------------------------+------------+------------+------------+\n");
+    
+    // Display all records
+    for (int n = 0; n < recordCount; n++) {
+        int i = n;
+        if (viewId != VIEW_STORED) {
+            i = views[viewId].order[descending ? recordCount - 1 - n : n];
+        }
+        printRecordRow(&records[i]);
+    }
+    flushRows();
+    
+    printf("+------------+--------------------------------------+------------+------------+------------+\n");
+    printf("\nTotal Records: %d\n", recordCount);
+}
+
+// 3. SEARCH MENU - Allows user to choose search criteria
+void searchMenu() {
+    int choice;
+    
+    while (1) {
+        printf("\n==============================================================\n");
+        printf("                    SEARCH MENU                               \n");
+        printf("--------------------------------------------------------------\n");
+        printf("  1. Search by ID                                            \n");
+        printf("  2. Search by Date                                          \n");
+        printf("  3. Search by Date Range                                    \n");
+        printf("  4. Search by Price Range                                   \n");
+        printf("  5. Search by Name                                          \n");
+        printf("  6. Search by Category                                      \n");
+        printf("  7. Top-K (Most Expensive, Cheapest, Newest, Oldest)        \n");
+        printf("  8. Price Band Summary (counts and values)                  \n");
+        printf("  9. Combined Query (e.g. category=iPhones AND price>500)    \n");
+        printf(" 10. Suggest Names (prefix autocomplete)                     \n");
+        printf(" 11. Stock by Model (units and value per model)              \n");
+        printf(" 12. Stock Timeline (by month/year, cumulative, window)      \n");
+        printf(" 13. Approximate Count / Sum / Average (sampled)             \n");
+        printf(" 14. Back to Main Menu                                       \n");
+        printf("==============================================================\n");
+        printCenteredNoNL("Enter your choice (1-14): ");
+        fflush(stdout);
+        
+        if (scanf("%d", &choice) != 1) {
+            clearInputBuffer();
+            printf("[ERROR] Invalid input! Please enter a number.\n");
+            printf("Press Enter to continue...");
+            fflush(stdout);
+            getchar();
+            continue;
+        }
+        
+        clearInputBuffer();
+        
+        switch(choice) {
+            case 1:
+                searchByID();
+                return;
+            case 2:
+                searchByDate();
+                return;
+            case 3:
+                searchByDateRange();
+                return;
+            case 4:
+                searchByPriceRange();
+                return;
+            case 5:
+                searchByName();
+                return;
+            case 6:
+                searchByCategory();
+                return;
+            case 7:
+                topKQuery();
+                return;
+            case 8:
+                priceBandSummary();
+                return;
+            case 9:
+                combinedQuery();
+                return;
+            case 10:
+                suggestNames();
+                return;
+            case 11:
+                stockByModel();
+                return;
+            case 12:
+                stockTimeline();
+                return;
+            case 13:
+                approximateAggregates();
+                return;
+            case 14:
+                return;  // Back to main menu
+            default:
+                printf("[ERROR] Invalid choice! Please select 1-14.\n");
+                printf("Press Enter to continue...");
+                fflush(stdout);
+                getchar();
+        }
+    }
+}
+
+// SEARCH FOR A RECORD BY ID
+void searchByID() {
+    int searchID;
+    int found = 0;
+    
+    printf("\n==============================================================\n");
+    printf("              SEARCH RECORD BY ID                             \n");
+    printf("==============================================================\n\n");
+    
+    printf("Enter Product ID to search: ");
+    fflush(stdout);
+    if (scanf("%d", &searchID) != 1) {
+        clearInputBuffer();
+        printf("[ERROR] Invalid ID format!\n");
+        return;
+    }
+    
+    clearInputBuffer();
+    
+    // Search for the record
+    int i = findSlotByID(searchID);
+    if (i >= 0) {
+        printf("\n[OK] Record Found!\n");
+        printf("+--------------------------------------------------------+\n");
+        printf("| Product ID    : %-40d |\n", records[i].id);
+        printf("| Product Name  : %-40s |\n", records[i].productName);
+        printf("| Price         : $%-38.2f |\n", records[i].price);
+        printf("| Date          : %-40s |\n", records[i].date);
+        printf("| Category      : %-40s |\n", records[i].category);
+        printf("+--------------------------------------------------------+\n");
+        found = 1;
+    }
+    
+    if (!found) {
+        printf("\n[ERROR] Record with ID %d not found!\n", searchID);
+    }
+}
+
+// SEARCH FOR RECORDS BY DATE
+void searchByDate() {
+    char searchDate[MAX_DATE_LENGTH];
+    int found = 0;
+    int foundCount = 0;
+    
+    printf("\n==============================================================\n");
+    printf("              SEARCH RECORD BY DATE                           \n");
+    printf("==============================================================\n\n");
+    
+    printf("Enter Date to search (DD/MM/YYYY): ");
+    fflush(stdout);
+    if (fgets(searchDate, MAX_DATE_LENGTH, stdin) == NULL) {
+        printf("[ERROR] Failed to read date!\n");
+        return;
+    }
+    
+    // Remove newline character
+    searchDate[strcspn(searchDate, "\n")] = 0;
+    
+    // Validate date format
+    if (!validateDate(searchDate)) {
+        return;
+    }
+    
+    // Search for records matching the date (binary search in the date view)
+    printf("\nSearching for records with date: %s\n", searchDate);
+    printf("+------------+--------------------------------------+------------+------------+------------+\n");
+    printf("| Product ID | Product Name                         | Price      | Date       | Category   |\n");
+    printf("+------------+--------------------------------------+------------+------------+------------+\n");
+    
+    int key = dateToKey(searchDate);
+    for (int pos = dateIndexLowerBound(key); pos < views[VIEW_DATE].count; pos++) {
+        int i = views[VIEW_DATE].order[pos];
+        if (dateToKey(records[i].date) != key) break;
+        printRecordRow(&records[i]);
+        found = 1;
+        foundCount++;
+    }
+    flushRows();
+    
+    printf("+------------+--------------------------------------+------------+------------+------------+\n");
+    
+    if (!found) {
+        printf("\n[ERROR] No records found with date %s!\n", searchDate);
+    } else {
+        printf("\n[OK] Found %d record(s) with date %s!\n", foundCount, searchDate);
+    }
+}
+
+// SEARCH FOR RECORDS IN A DATE RANGE (inclusive)
+void searchByDateRange() {
+    char fromDate[MAX_DATE_LENGTH];
+    char toDate[MAX_DATE_LENGTH];
+    int foundCount = 0;
+    
+    printf("\n==============================================================\n");
+    printf("              SEARCH RECORD BY DATE RANGE                     \n");
+    printf("==============================================================\n\n");
+    
+    printf("Enter start Date (DD/MM/YYYY): ");
+    fflush(stdout);
+    if (fgets(fromDate, MAX_DATE_LENGTH, stdin) == NULL) {
+        printf("[ERROR] Failed to read date!\n");
+        return;
+    }
+    fromDate[strcspn(fromDate, "\n")] = 0;
+    if (!validateDate(fromDate)) {
+        return;
+    }
+    
+    printf("Enter end Date (DD/MM/YYYY): ");
+    fflush(stdout);
+    if (fgets(toDate, MAX_DATE_LENGTH, stdin) == NULL) {
+        printf("[ERROR] Failed to read date!\n");
+        return;
+    }
+    toDate[strcspn(toDate, "\n")] = 0;
+    if (!validateDate(toDate)) {
+        return;
+    }
+    
+    int fromKey = dateToKey(fromDate);
+    int toKey = dateToKey(toDate);
+    if (fromKey > toKey) {
+        printf("[ERROR] Start date must not be after end date!\n");
+        return;
+    }
+    
+    printf("\nSearching for records from %s to %s\n", fromDate, toDate);
+    printf("+------------+--------------------------------------+------------+------------+------------+\n");
+    printf("| Product ID | Product Name                         | Price      | Date       | Category   |\n");
+    printf("+------------+--------------------------------------+------------+------------+------------+\n");
+    
+    // Binary search to the first date in range, then walk the view: O(log n + matches)
+    for (int pos = dateIndexLowerBound(fromKey); pos < views[VIEW_DATE].count; pos++) {
+        int i = views[VIEW_DATE].order[pos];
+        if (dateToKey(records[i].date) > toKey) break;
+        printRecordRow(&records[i]);
+        foundCount++;
+    }
+    flushRows();
+    
+    printf("+------------+--------------------------------------+------------+------------+------------+\n");
+    
+    if (foundCount == 0) {
+        printf("\n[ERROR] No records found between %s and %s!\n", fromDate, toDate);
+    } else {
+        printf("\n[OK] Found %d record(s) between %s and %s!\n", foundCount, fromDate, toDate);
+    }
+}
+
+// SEARCH FOR RECORDS IN A PRICE RANGE (inclusive)
+void searchByPriceRange() {
+    float minPrice, maxPrice;
+    int foundCount = 0;
+    double totalValue = 0;
+    
+    printf("\n==============================================================\n");
+    printf("              SEARCH RECORD BY PRICE RANGE                    \n");
+    printf("==============================================================\n\n");
+    
+    printf("Enter minimum Price ($): ");
+    fflush(stdout);
+    if (scanf("%f", &minPrice) != 1) {
+        clearInputBuffer();
+        printf("[ERROR] Invalid price format!\n");
+        return;
+    }
+    clearInputBuffer();
+    
+    printf("Enter maximum Price ($): ");
+    fflush(stdout);
+    if (scanf("%f", &maxPrice) != 1) {
+        clearInputBuffer();
+        printf("[ERROR] Invalid price format!\n");
+        return;
+    }
+    clearInputBuffer();
+    
+    if (minPrice > maxPrice) {
+        printf("[ERROR] Minimum price must not be above maximum price!\n");
+        return;
+    }
+    
+    printf("\nSearching for records from $%.2f to $%.2f\n", minPrice, maxPrice);
+    printf("+------------+--------------------------------------+------------+------------+------------+\n");
+    printf("| Product ID | Product Name                         | Price      | Date       | Category   |\n");
+    printf("+------------+--------------------------------------+------------+------------+------------+\n");
+    
+    // Binary search the price view, then walk it: O(log n + matches)
+    int from = viewLowerBound(VIEW_PRICE, minPrice, 0);
+    int to = viewLowerBound(VIEW_PRICE, maxPrice, 1);
+    for (int pos = from; pos < to; pos++) {
+        int i = views[VIEW_PRICE].order[pos];
+        printRecordRow(&records[i]);
+        totalValue += records[i].price;
+        foundCount++;
+    }
+    flushRows();
+    
+    printf("+------------+--------------------------------------+------------+------------+------------+\n");
+    
+    if (foundCount == 0) {
+        printf("\n[ERROR] No records found between $%.2f and $%.2f!\n", minPrice, maxPrice);
+    } else {
+        printf("\n[OK] Found %d record(s), Total Value: $%.2f\n", foundCount, totalValue);
+    }
+}
+
+// PRICE BAND SUMMARY
+// Answered from the price histogram alone: O(buckets), no record is read
+void priceBandSummary() {
+    int minPrice, maxPrice, bandWidth;
+    
+    printf("\n==============================================================\n");
+    printf("              PRICE BAND SUMMARY                              \n");
+    printf("==============================================================\n\n");
+    
+    printf("Bands are multiples of $%d.\n", PRICE_BUCKET_WIDTH);
+    printf("Enter minimum Price ($): ");
+    fflush(stdout);
+    if (scanf("%d", &minPrice) != 1) {
+        clearInputBuffer();
+        printf("[ERROR] Invalid price format!\n");
+        return;
+    }
+    clearInputBuffer();
+    
+    printf("Enter maximum Price ($): ");
+    fflush(stdout);
+    if (scanf("%d", &maxPrice) != 1) {
+        clearInputBuffer();
+        printf("[ERROR] Invalid price format!\n");
+        return;
+    }
+    clearInputBuffer();
+    
+    printf("Enter band width ($, multiple of %d): ", PRICE_BUCKET_WIDTH);
+    fflush(stdout);
+    if (scanf("%d", &bandWidth) != 1) {
+        clearInputBuffer();
+        printf("[ERROR] Invalid band width!\n");
+        return;
+    }
+    clearInputBuffer();
+    
+    if (minPrice < 0 || maxPrice <= minPrice) {
+        printf("[ERROR] Maximum price must be above a non-negative minimum price!\n");
+        return;
+    }
+    if (bandWidth < PRICE_BUCKET_WIDTH || bandWidth % PRICE_BUCKET_WIDTH != 0) {
+        printf("[ERROR] Band width must be a multiple of $%d!\n", PRICE_BUCKET_WIDTH);
+        return;
+    }
+    
+    // Snap the window to bucket edges
+    int firstBucket = minPrice / PRICE_BUCKET_WIDTH;
+    int lastBucket = (maxPrice + PRICE_BUCKET_WIDTH - 1) / PRICE_BUCKET_WIDTH - 1;
+    if (lastBucket >= PRICE_BUCKETS) lastBucket = PRICE_BUCKETS - 1;
+    int bucketsPerBand = bandWidth / PRICE_BUCKET_WIDTH;
+    int totalCount = 0;
+    double totalValue = 0;
+    
+    printf("\n+--------------------------+------------+-----------------+\n");
+    printf("| Price Band               | Items      | Total Value     |\n");
+    printf("+--------------------------+------------+-----------------+\n");
+    
+    for (int band = firstBucket; band <= lastBucket; band += bucketsPerBand) {
+        int count = 0;
+        double value = 0;
+        for (int b = band; b < band + bucketsPerBand && b <= lastBucket; b++) {
+            count += priceBucketCount[b];
+            value += priceBucketValue[b];
+        }
+        char label[40];
+        sprintf(label, "$%d - $%d", band * PRICE_BUCKET_WIDTH, (band + bucketsPerBand) * PRICE_BUCKET_WIDTH);
+        printf("| %-24s | %-10d | $%-14.2f |\n", label, count, value);
+        totalCount += count;
+        totalValue += value;
+    }
+    
+    printf("+--------------------------+------------+-----------------+\n");
+    printf("| %-24s | %-10d | $%-14.2f |\n", "TOTAL", totalCount, totalValue);
+    printf("+--------------------------+------------+-----------------+\n");
+}
+
+// Read and validate a DD/MM/YYYY date; returns its YYYYMMDD key, or 0
+int promptDateKey(const char* prompt) {
+    char date[MAX_DATE_LENGTH];
+    
+    printf("%s", prompt);
+    fflush(stdout);
+    if (fgets(date, MAX_DATE_LENGTH, stdin) == NULL) {
+        printf("[ERROR] Failed to read date!\n");
+        return 0;
+    }
+    date[strcspn(date, "\n")] = 0;
+    if (!validateDate(date)) {
+        return 0;
+    }
+    return dateToKey(date);
+}
+
+// STOCK TIMELINE
+// Value received per month or year, cumulative value up to a date and totals
+// for a date window, all from the calendar rollup
+void stockTimeline() {
+    static const char* monthNames[] = {"January", "February", "March", "April", "May", "June", "July",
+                                       "August", "September", "October", "November", "December"};
+    int choice;
+    int count;
+    double value;
+    
+    printf("\n==============================================================\n");
+    printf("              STOCK TIMELINE                                  \n");
+    printf("--------------------------------------------------------------\n");
+    printf("  1. Monthly Totals for a Year (with cumulative value)       \n");
+    printf("  2. Yearly Totals                                           \n");
+    printf("  3. Cumulative Value up to a Date                           \n");
+    printf("  4. Totals Between Two Dates                                \n");
+    printf("==============================================================\n");
+    printCenteredNoNL("Enter your choice (1-4): ");
+    fflush(stdout);
+    if (scanf("%d", &choice) != 1) {
+        clearInputBuffer();
+        printf("[ERROR] Invalid input! Please enter a number.\n");
+        return;
+    }
+    clearInputBuffer();
+    
+    if (choice == 1) {
+        int year;
+        printf("Enter year (%d-%d): ", CALENDAR_FIRST_YEAR, CALENDAR_FIRST_YEAR + CALENDAR_YEARS - 1);
+        fflush(stdout);
+        if (scanf("%d", &year) != 1) {
+            clearInputBuffer();
+            printf("[ERROR] Invalid year!\n");
+            return;
+        }
+        clearInputBuffer();
+        if (year < CALENDAR_FIRST_YEAR || year >= CALENDAR_FIRST_YEAR + CALENDAR_YEARS) {
+            printf("[ERROR] Year must be between %d and %d!\n", CALENDAR_FIRST_YEAR, CALENDAR_FIRST_YEAR + CALENDAR_YEARS - 1);
+            return;
+        }
+        
+        int firstMonth = (year - CALENDAR_FIRST_YEAR) * 12;
+        int yearItems = 0;
+        double yearTotal = 0;
+        double cumulative;
+        calendarPrefix(firstMonth * 31 - 1, &count, &cumulative);
+        
+        printf("\nStock received in %d\n", year);
+        printf("+------------+------------+-----------------+-----------------+\n");
+        printf("| Month      | Items      | Value           | Cumulative      |\n");
+        printf("+------------+------------+-----------------+-----------------+\n");
+        for (int m = 0; m < 12; m++) {
+            cumulative += monthValue[firstMonth + m];
+            printf("| %-10s | %-10d | $%-14.2f | $%-14.2f |\n", monthNames[m],
+                   monthCount[firstMonth + m], monthValue[firstMonth + m], cumulative);
+            yearItems += monthCount[firstMonth + m];
+            yearTotal += monthValue[firstMonth + m];
         }
+        printf("+------------+------------+-----------------+-----------------+\n");
+        printf("| %-10s | %-10d | $%-14.2f | $%-14.2f |\n", "TOTAL", yearItems, yearTotal, cumulative);
+        printf("+------------+------------+-----------------+-----------------+\n");
+    } else if (choice == 2) {
+        int totalItems = 0;
+        double totalValue = 0;
         
-        // Get Date (common for all items)
+        printf("\n+------------+------------+-----------------+-----------------+\n");
+        printf("| Year       | Items      | Value           | Cumulative      |\n");
+        printf("+------------+------------+-----------------+-----------------+\n");
+        for (int y = 0; y < CALENDAR_YEARS; y++) {
+            if (yearCount[y] == 0) continue;
+            totalItems += yearCount[y];
+            totalValue += yearValue[y];
+            printf("| %-10d | %-10d | $%-14.2f | $%-14.2f |\n",
+                   CALENDAR_FIRST_YEAR + y, yearCount[y], yearValue[y], totalValue);
+        }
+        printf("+------------+------------+-----------------+-----------------+\n");
+        printf("| %-10s | %-10d | $%-14.2f |                 |\n", "TOTAL", totalItems, totalValue);
+        printf("+------------+------------+-----------------+-----------------+\n");
+    } else if (choice == 3) {
+        int key = promptDateKey("Enter Date (DD/MM/YYYY): ");
+        if (key == 0) return;
+        calendarPrefix(calendarDay(key), &count, &value);
+        printf("\n[OK] Received up to and including %02d/%02d/%04d: %d item(s), Total Value: $%.2f\n",
+               key % 100, key / 100 % 100, key / 10000, count, value);
+    } else if (choice == 4) {
+        int fromKey = promptDateKey("Enter start Date (DD/MM/YYYY): ");
+        if (fromKey == 0) return;
+        int toKey = promptDateKey("Enter end Date (DD/MM/YYYY): ");
+        if (toKey == 0) return;
+        if (fromKey > toKey) {
+            printf("[ERROR] Start date must not be after end date!\n");
+            return;
+        }
+        calendarWindow(fromKey, toKey, &count, &value);
+        printf("\n[OK] Received between the two dates: %d item(s), Total Value: $%.2f\n", count, value);
+    } else {
+        printf("[ERROR] Invalid choice! Please select 1-4.\n");
+        return;
+    }
+    
+    if (undatedCount > 0) {
+        printf("\nNote: %d record(s) worth $%.2f have dates outside %d-%d and are not included.\n",
+               undatedCount, undatedValue, CALENDAR_FIRST_YEAR, CALENDAR_FIRST_YEAR + CALENDAR_YEARS - 1);
+    }
+}
+
+// Read an optional DD/MM/YYYY date: returns its YYYYMMDD key, 0 if left
+// empty, or -1 if invalid
+int promptOptionalDateKey(const char* prompt) {
+    char date[MAX_DATE_LENGTH];
+    
+    printf("%s", prompt);
+    fflush(stdout);
+    if (fgets(date, MAX_DATE_LENGTH, stdin) == NULL) {
+        printf("[ERROR] Failed to read date!\n");
+        return -1;
+    }
+    date[strcspn(date, "\n")] = 0;
+    if (date[0] == '\0') return 0;
+    if (!validateDate(date)) return -1;
+    return dateToKey(date);
+}
+
+// Read an optional price: returns 1 and sets *price (-1 if left empty), or 0
+int promptOptionalPrice(const char* prompt, float* price) {
+    char input[32];
+    
+    printf("%s", prompt);
+    fflush(stdout);
+    if (fgets(input, sizeof(input), stdin) == NULL) {
+        printf("[ERROR] Failed to read price!\n");
+        return 0;
+    }
+    *price = -1;
+    if (input[0] == '\n') return 1;
+    if (sscanf(input, "%f", price) != 1 || *price < 0) {
+        printf("[ERROR] Invalid price format!\n");
+        return 0;
+    }
+    return 1;
+}
+
+// APPROXIMATE AGGREGATES - count, total value and average price with 95%
+// confidence intervals, read from the per-category samples only
+void approximateAggregates() {
+    char category[MAX_CATEGORY_NAME];
+    float minPrice, maxPrice;
+    double estimates[3], margins[3];
+    int population;
+    LARGE_INTEGER frequency, start, end;
+    
+    printf("\n==============================================================\n");
+    printf("              APPROXIMATE AGGREGATES (SAMPLED)                \n");
+    printf("==============================================================\n\n");
+    printf("Up to %d records per category are sampled; press Enter to leave a filter open.\n", SAMPLE_CAPACITY);
+    
+    printf("Category (Enter for all): ");
+    fflush(stdout);
+    if (fgets(category, sizeof(category), stdin) == NULL) {
+        printf("[ERROR] Failed to read category!\n");
+        return;
+    }
+    category[strcspn(category, "\n")] = 0;
+    
+    int fromKey = promptOptionalDateKey("Start Date (DD/MM/YYYY, Enter for any): ");
+    if (fromKey < 0) return;
+    int toKey = promptOptionalDateKey("End Date (DD/MM/YYYY, Enter for any): ");
+    if (toKey < 0) return;
+    if (fromKey != 0 && toKey != 0 && fromKey > toKey) {
+        printf("[ERROR] Start date must not be after end date!\n");
+        return;
+    }
+    if (!promptOptionalPrice("Minimum Price ($, Enter for any): ", &minPrice)) return;
+    if (!promptOptionalPrice("Maximum Price ($, Enter for any): ", &maxPrice)) return;
+    
+    QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&start);
+    int itemsRead = approximateAggregate(category[0] != '\0' ? category : NULL, fromKey, toKey,
+                                         minPrice, maxPrice, estimates, margins, &population);
+    QueryPerformanceCounter(&end);
+    double micros = (double)(end.QuadPart - start.QuadPart) * 1000000.0 / (double)frequency.QuadPart;
+    
+    if (population == 0) {
+        printf("\n[ERROR] No records in %s!\n", category[0] != '\0' ? category : "the store");
+        return;
+    }
+    
+    printf("\n+--------------+-----------------+-----------------+-----------------------------------+\n");
+    printf("| Measure      | Estimate        | +/- (95%%)       | 95%% Confidence Interval           |\n");
+    printf("+--------------+-----------------+-----------------+-----------------------------------+\n");
+    for (int m = 0; m < 3; m++) {
+        static const char* names[] = {"Count", "Total Value", "Avg Price"};
+        char interval[128];   // Loaded prices are not range-checked
+        double low = estimates[m] - margins[m];
+        if (low < 0) low = 0;
+        if (m == 0) {
+            snprintf(interval, sizeof(interval), "%.1f - %.1f", low, estimates[m] + margins[m]);
+            printf("| %-12s | %-15.1f | %-15.1f | %-33s |\n", names[m], estimates[m], margins[m], interval);
+        } else {
+            snprintf(interval, sizeof(interval), "$%.2f - $%.2f", low, estimates[m] + margins[m]);
+            printf("| %-12s | $%-14.2f | $%-14.2f | %-33s |\n", names[m], estimates[m], margins[m], interval);
+        }
+    }
+    printf("+--------------+-----------------+-----------------+-----------------------------------+\n");
+    printf("\n[OK] Read %d sampled record(s) standing for %d in %.1f microseconds.\n", itemsRead, population, micros);
+    if (estimates[0] == 0) {
+        printf("No sampled record matched; matching records may still exist in small numbers.\n");
+    }
+}
+
+// STOCK BY MODEL - units and value per (category, product) from the model index
+void stockByModel() {
+    char input[20];
+    int choice;
+    int totalCount = 0;
+    double totalValue = 0;
+    
+    printf("\n==============================================================\n");
+    printf("              STOCK BY MODEL                                  \n");
+    printf("==============================================================\n\n");
+    
+    if (modelCount == 0) {
+        printf("[ERROR] No records in stock!\n");
+        return;
+    }
+    
+    printf("+-----+------------+--------------------------------------+-------+-----------------+\n");
+    printf("| #   | Category   | Product Name                         | Units | Total Value     |\n");
+    printf("+-----+------------+--------------------------------------+-------+-----------------+\n");
+    for (int m = 0; m < modelCount; m++) {
+        printf("| %-3d | %-10s | %-36s | %-5d | $%-14.2f |\n",
+               m + 1, modelIndex[m].category, modelIndex[m].productName,
+               modelIndex[m].count, modelIndex[m].value);
+        totalCount += modelIndex[m].count;
+        totalValue += modelIndex[m].value;
+    }
+    printf("+-----+------------+--------------------------------------+-------+-----------------+\n");
+    printf("| %-3s | %-10s | %-36s | %-5d | $%-14.2f |\n", "", "TOTAL", "", totalCount, totalValue);
+    printf("+-----+------------+--------------------------------------+-------+-----------------+\n");
+    
+    printf("\nEnter a model # to list its units (or press Enter to go back): ");
+    fflush(stdout);
+    if (fgets(input, sizeof(input), stdin) == NULL) return;
+    if (sscanf(input, "%d", &choice) != 1) return;
+    if (choice < 1 || choice > modelCount) {
+        printf("[ERROR] Invalid model number!\n");
+        return;
+    }
+    
+    const ModelEntry* entry = &modelIndex[choice - 1];
+    printf("\n%s (%s): %d unit(s)\n", entry->productName, entry->category, entry->count);
+    printf("+------------+--------------------------------------+------------+------------+------------+\n");
+    printf("| Product ID | Product Name                         | Price      | Date       | Category   |\n");
+    printf("+------------+--------------------------------------+------------+------------+------------+\n");
+    for (int i = bitmapNext(&entry->members, 0); i >= 0 && i < recordCount; i = bitmapNext(&entry->members, i + 1)) {
+        printRecordRow(&records[i]);
+    }
+    flushRows();
+    printf("+------------+--------------------------------------+------------+------------+------------+\n");
+}
+
+// SEARCH FOR RECORDS BY NAME
+void searchByName() {
+    char searchName[MAX_NAME_LENGTH];
+    char queryLower[MAX_NAME_LENGTH];
+    int found = 0;
+    int foundCount = 0;
+    
+    printf("\n==============================================================\n");
+    printf("              SEARCH RECORD BY NAME                           \n");
+    printf("==============================================================\n\n");
+    
+    printf("Enter Product Name to search (end with * for suggestions): ");
+    fflush(stdout);
+    if (fgets(searchName, MAX_NAME_LENGTH, stdin) == NULL) {
+        printf("[ERROR] Failed to read product name!\n");
+        return;
+    }
+    
+    // Remove newline character
+    searchName[strcspn(searchName, "\n")] = 0;
+    completeFromSuggestions(searchName, sizeof(searchName));
+    
+    if (strlen(searchName) == 0) {
+        printf("[ERROR] Product name cannot be empty!\n");
+        return;
+    }
+    
+    // Search for records matching the name (case-insensitive partial match)
+    printf("\nSearching for records containing: %s\n", searchName);
+    printf("+------------+--------------------------------------+------------+------------+------------+\n");
+    printf("| Product ID | Product Name                         | Price      | Date       | Category   |\n");
+    printf("+------------+--------------------------------------+------------+------------+------------+\n");
+    
+    toLowerCase(searchName, queryLower, sizeof(queryLower));
+    int queryLength = (int)strlen(queryLower);
+    
+    // Same key as a combined query "name~..." term, so the two share results
+    char key[QUERY_KEY_LENGTH];
+    Bitmap matched;
+    snprintf(key, sizeof(key), "name~%s", queryLower);
+    const Bitmap* cached = queryCacheLookup(key);
+    if (cached != NULL) {
+        matched = *cached;
+    } else {
+        memset(&matched, 0, sizeof(matched));
+        // Candidates come from the shortest posting list among the query's
+        // trigrams; queries under 3 characters have no trigram and scan all
+        // records, as does every query while the index is incomplete
+        const PostingList* lists[MAX_NAME_LENGTH];
+        int listCount = 0;
+        const PostingList* shortest = NULL;
+        for (int t = 0; t + 2 < queryLength && !trigramIndexIncomplete; t++) {
+            const PostingList* list = &trigramIndex[trigramBucket(&queryLower[t])];
+            lists[listCount++] = list;
+            if (shortest == NULL || list->count < shortest->count) shortest = list;
+        }
+        
+        int candidateCount = (shortest != NULL) ? shortest->count : recordCount;
+        for (int c = 0; c < candidateCount; c++) {
+            int i = (shortest != NULL) ? shortest->slots[c] : c;
+            
+            // Intersect with the remaining posting lists
+            int inAll = 1;
+            for (int l = 0; l < listCount && inAll; l++) {
+                if (lists[l] != shortest && !postingContains(lists[l], i)) inAll = 0;
+            }
+            if (!inAll) continue;
+            
+            // Trigrams can collide or appear out of order, so confirm the substring
+            if (strstr(nameFoldedColumn[i], queryLower) != NULL) {
+                bitmapSet(&matched, i);
+            }
+        }
+        queryCacheStore(key, &matched);
+    }
+    
+    for (int i = bitmapNext(&matched, 0); i >= 0 && i < recordCount; i = bitmapNext(&matched, i + 1)) {
+        printRecordRow(&records[i]);
+        found = 1;
+        foundCount++;
+    }
+    flushRows();
+    
+    printf("+------------+--------------------------------------+------------+------------+------------+\n");
+    
+    if (!found) {
+        printf("\n[ERROR] No records found containing '%s'!\n", searchName);
+        fuzzySearchByName(queryLower);
+    } else {
+        printf("\n[OK] Found %d record(s) containing '%s'!\n", foundCount, searchName);
+    }
+}
+
+// Smallest edit distance between the pattern and any substring of the
+// lowercased text (Myers' bit-parallel algorithm; peq holds one match mask
+// per character)
+int myersDistance(const unsigned long long* peq, int patternLength, const char* text) {
+    unsigned long long pv = ~0ULL, mv = 0;
+    unsigned long long last = 1ULL << (patternLength - 1);
+    int score = patternLength;
+    int best = patternLength;
+    
+    for (const char* t = text; *t != '\0'; t++) {
+        unsigned long long eq = peq[(unsigned char)*t];
+        unsigned long long xv = eq | mv;
+        unsigned long long xh = (((eq & pv) + pv) ^ pv) | eq;
+        unsigned long long ph = mv | ~(xh | pv);
+        unsigned long long mh = pv & xh;
+        
+        if (ph & last) score++;
+        else if (mh & last) score--;
+        
+        // No carry-in: a match may start anywhere in the text
+        ph <<= 1;
+        mh <<= 1;
+        pv = mh | ~(xv | ph);
+        mv = ph & xv;
+        
+        if (score < best) best = score;
+    }
+    return best;
+}
+
+// Closest first, then by name and ID
+int compareFuzzyMatches(const void* a, const void* b) {
+    const FuzzyMatch* x = (const FuzzyMatch*)a;
+    const FuzzyMatch* y = (const FuzzyMatch*)b;
+    if (x->distance != y->distance) return x->distance - y->distance;
+    int byName = strcmp(records[x->slot].productName, records[y->slot].productName);
+    if (byName != 0) return byName;
+    return records[x->slot].id - records[y->slot].id;
+}
+
+// Approximate match on product names, ranked by edit distance; returns the
+// number of records listed
+int fuzzySearchByName(const char* queryLower) {
+    int patternLength = (int)strlen(queryLower);
+    if (patternLength < 3) return 0;
+    
+    int maxDistance = patternLength / 3;
+    unsigned long long peq[256];
+    memset(peq, 0, sizeof(peq));
+    for (int i = 0; i < patternLength; i++) {
+        peq[(unsigned char)queryLower[i]] |= 1ULL << i;
+    }
+    
+    // q-gram filter: each edit breaks at most 3 of the query's trigrams, so a
+    // match keeps at least (distinct trigrams - 3 * maxDistance) of them
+    unsigned int buckets[MAX_NAME_LENGTH];
+    int bucketCount = 0;
+    for (int t = 0; t + 2 < patternLength; t++) {
+        unsigned int bucket = trigramBucket(&queryLower[t]);
+        int seen = 0;
+        for (int b = 0; b < bucketCount; b++) {
+            if (buckets[b] == bucket) seen = 1;
+        }
+        if (!seen) buckets[bucketCount++] = bucket;
+    }
+    int required = trigramIndexIncomplete ? 0 : bucketCount - 3 * maxDistance;
+    
+    unsigned char hits[MAX_RECORDS];
+    memset(hits, 0, sizeof(hits));
+    if (required > 0) {
+        for (int b = 0; b < bucketCount; b++) {
+            const PostingList* list = &trigramIndex[buckets[b]];
+            for (int i = 0; i < list->count; i++) hits[list->slots[i]]++;
+        }
+    }
+    
+    FuzzyMatch matches[MAX_RECORDS];
+    int matchCount = 0;
+    int checked = 0;
+    for (int i = 0; i < recordCount; i++) {
+        if (required > 0 && hits[i] < required) continue;
+        checked++;
+        int distance = myersDistance(peq, patternLength, nameFoldedColumn[i]);
+        if (distance <= maxDistance) {
+            matches[matchCount].slot = i;
+            matches[matchCount].distance = distance;
+            matchCount++;
+        }
+    }
+    
+    if (matchCount == 0) return 0;
+    qsort(matches, matchCount, sizeof(FuzzyMatch), compareFuzzyMatches);
+    
+    printf("\nDid you mean (up to %d edit(s), %d of %d record(s) checked):\n", maxDistance, checked, recordCount);
+    printf("+------+------------+--------------------------------------+------------+------------+------------+\n");
+    printf("| Dist | Product ID | Product Name                         | Price      | Date       | Category   |\n");
+    printf("+------+------------+--------------------------------------+------------+------------+------------+\n");
+    for (int m = 0; m < matchCount; m++) {
+        int i = matches[m].slot;
+        char* out = reserveRow();
+        size_t length = appendPaddedText(out, "| ", 0);
+        length += appendPaddedInt(out + length, matches[m].distance, 4);
+        out[length++] = ' ';
+        rowBufferLength += length + formatRecordRow(out + length, &records[i]);
+    }
+    flushRows();
+    printf("+------+------------+--------------------------------------+------------+------------+------------+\n");
+    printf("\n[OK] Found %d close match(es)!\n", matchCount);
+    return matchCount;
+}
+
+// SEARCH FOR RECORDS BY CATEGORY
+void searchByCategory() {
+    char searchCategory[20];
+    int foundCount = 0;
+    
+    printf("\n==============================================================\n");
+    printf("            SEARCH RECORD BY CATEGORY                         \n");
+    printf("==============================================================\n\n");
+    
+    printf("Enter Category to search (e.g., iPhones, MacBooks, iWatch): ");
+    fflush(stdout);
+    if (fgets(searchCategory, sizeof(searchCategory), stdin) == NULL) {
+        printf("[ERROR] Failed to read category!\n");
+        return;
+    }
+    
+    searchCategory[strcspn(searchCategory, "\n")] = 0;
+    
+    if (strlen(searchCategory) == 0) {
+        printf("[ERROR] Category cannot be empty!\n");
+        return;
+    }
+    
+    // One case-folded lookup, then only the member slots are visited
+    CategoryIndexEntry* entry = findCategoryEntry(searchCategory, 0);
+    if (entry == NULL || bitmapCount(&entry->members) == 0) {
+        printf("\n[ERROR] No records found in category '%s'!\n", searchCategory);
+        return;
+    }
+    
+    printf("\nSearching for records in category: %s\n", searchCategory);
+    printf("+------------+--------------------------------------+------------+------------+------------+\n");
+    printf("| Product ID | Product Name                         | Price      | Date       | Category   |\n");
+    printf("+------------+--------------------------------------+------------+------------+------------+\n");
+    
+    for (int i = bitmapNext(&entry->members, 0); i >= 0; i = bitmapNext(&entry->members, i + 1)) {
+        printRecordRow(&records[i]);
+        foundCount++;
+    }
+    flushRows();
+    
+    printf("+------------+--------------------------------------+------------+------------+------------+\n");
+    printf("\n[OK] Found %d record(s) in category '%s'!\n", foundCount, searchCategory);
+}
+
+// TOP-K QUERY
+// Reads the first or last K entries of a sorted view: O(K), records[] is not
+// reordered and nothing is written to disk
+void topKQuery() {
+    int choice;
+    int k;
+    int viewId;
+    int descending;
+    const char* label;
+    
+    printf("\n==============================================================\n");
+    printf("              TOP-K QUERY                                     \n");
+    printf("==============================================================\n\n");
+    
+    if (recordCount == 0) {
+        printf("[ERROR] No records found in the system!\n");
+        return;
+    }
+    
+    printf("  1. Most Expensive\n");
+    printf("  2. Cheapest\n");
+    printf("  3. Newest\n");
+    printf("  4. Oldest\n");
+    printf("Enter choice (1-4): ");
+    fflush(stdout);
+    if (scanf("%d", &choice) != 1 || choice < 1 || choice > 4) {
         clearInputBuffer();
-        printf("Enter Date (DD/MM/YYYY): ");
-        fflush(stdout);
-        if (fgets(newRecord.date, MAX_DATE_LENGTH, stdin) == NULL) {
-            printf("[ERROR] Failed to read date!\n");
-            printf("Press Enter to continue...");
-            fflush(stdout);
-            getchar();
-            continue;
+        printf("[ERROR] Invalid choice!\n");
+        return;
     }
+    clearInputBuffer();
     
-    // Remove newline character
-        newRecord.date[strcspn(newRecord.date, "\n")] = 0;
-        
-        // Validate date format and values
-        if (!validateDate(newRecord.date)) {
-            printf("Press Enter to continue...");
-            fflush(stdout);
-            getchar();
-            continue;
+    printf("How many records (K): ");
+    fflush(stdout);
+    if (scanf("%d", &k) != 1 || k <= 0) {
+        clearInputBuffer();
+        printf("[ERROR] K must be a positive number!\n");
+        return;
+    }
+    clearInputBuffer();
+    if (k > recordCount) k = recordCount;
+    
+    switch(choice) {
+        case 1:
+            viewId = VIEW_PRICE; descending = 1; label = "Most Expensive";
+            break;
+        case 2:
+            viewId = VIEW_PRICE; descending = 0; label = "Cheapest";
+            break;
+        case 3:
+            viewId = VIEW_DATE; descending = 1; label = "Newest";
+            break;
+        default:
+            viewId = VIEW_DATE; descending = 0; label = "Oldest";
+            break;
+    }
+    
+    printf("\nTop %d %s:\n", k, label);
+    printf("+------------+--------------------------------------+------------+------------+------------+\n");
+    printf("| Product ID | Product Name                         | Price      | Date       | Category   |\n");
+    printf("+------------+--------------------------------------+------------+------------+------------+\n");
+    
+    for (int n = 0; n < k; n++) {
+        int i = views[viewId].order[descending ? recordCount - 1 - n : n];
+        printRecordRow(&records[i]);
+    }
+    flushRows();
+    
+    printf("+------------+--------------------------------------+------------+------------+------------+\n");
+    printf("\n[OK] Showing %d of %d record(s).\n", k, recordCount);
+}
+
+// COMBINED QUERY
+// Plans a conjunction of predicates: every predicate an index can answer
+// (category bitmap, price/date views, name trigrams) becomes a candidate
+// bitmap, the bitmaps are intersected from most to least selective, and only
+// the surviving slots are checked against the remaining predicates
+void combinedQuery() {
+    char text[MAX_QUERY_LENGTH];
+    QueryPredicate predicates[MAX_QUERY_PREDICATES];
+    int predicateCount = 0;
+    
+    printf("\n==============================================================\n");
+    printf("              COMBINED QUERY                                  \n");
+    printf("==============================================================\n\n");
+    printf("Fields: id, price, date, name, category\n");
+    printf("Operators: =  <  <=  >  >=  ~ (name contains)\n");
+    printf("Example: category=iPhones AND date>=01/03/2025 AND date<=31/03/2025 AND price>500\n\n");
+    printf("Enter query: ");
+    fflush(stdout);
+    if (fgets(text, sizeof(text), stdin) == NULL) {
+        printf("[ERROR] Failed to read query!\n");
+        return;
+    }
+    text[strcspn(text, "\n")] = 0;
+    
+    if (!parseQuery(text, predicates, &predicateCount)) {
+        return;
+    }
+    
+    // Reuse the result of an identical query if no record changed since
+    char key[QUERY_KEY_LENGTH];
+    int residual[MAX_QUERY_PREDICATES];   // 1 = still needs checking per record
+    Bitmap result;
+    int cacheable = normalizeQuery(predicates, predicateCount, key, sizeof(key));
+    const Bitmap* cached = cacheable ? queryCacheLookup(key) : NULL;
+    if (cached != NULL) {
+        result = *cached;
+        memset(residual, 0, sizeof(residual));
+        printf("\nExecution plan:\n");
+        printf("  1. Query cache hit -> %d record(s)\n", bitmapCount(&result));
+    } else {
+        planQuery(predicates, predicateCount, &result, residual);
+    }
+    
+    printf("\n+------------+--------------------------------------+------------+------------+------------+\n");
+    printf("| Product ID | Product Name                         | Price      | Date       | Category   |\n");
+    printf("+------------+--------------------------------------+------------+------------+------------+\n");
+    
+    int foundCount = 0;
+    Bitmap matched;
+    memset(&matched, 0, sizeof(matched));
+    for (int i = bitmapNext(&result, 0); i >= 0 && i < recordCount; i = bitmapNext(&result, i + 1)) {
+        int matches = 1;
+        for (int p = 0; p < predicateCount && matches; p++) {
+            if (residual[p] && !predicateMatches(&predicates[p], i)) matches = 0;
         }
-        
-        // Generate unique ID based on category
-        int nextID = generateNextID(categoryChoice);
-        if (nextID == -1) {
-            printf("[ERROR] Invalid category for ID generation!\n");
-            printf("Press Enter to continue...");
-            fflush(stdout);
-            getchar();
-            continue;
+        if (!matches) continue;
+        printRecordRow(&records[i]);
+        bitmapSet(&matched, i);
+        foundCount++;
+    }
+    flushRows();
+    
+    printf("+------------+--------------------------------------+------------+------------+------------+\n");
+    
+    if (foundCount == 0) {
+        printf("\n[ERROR] No records match the query!\n");
+    } else {
+        printf("\n[OK] Found %d record(s) matching the query!\n", foundCount);
+    }
+    
+    if (cacheable && cached == NULL) {
+        queryCacheStore(key, &matched);
+    }
+}
+
+// Build the candidate bitmap for a query from the indexes, printing the plan;
+// residual[p] is set for predicates that must still be checked per record
+void planQuery(const QueryPredicate* predicates, int predicateCount, Bitmap* out, int* residual) {
+    // Build one candidate bitmap per indexed access path
+    Bitmap steps[3 + MAX_QUERY_PREDICATES];
+    int stepSizes[3 + MAX_QUERY_PREDICATES];
+    const char* stepNames[3 + MAX_QUERY_PREDICATES];
+    int stepCount = 0;
+    char scanNames[3][40];
+    
+    // Price and date: fold all predicates on the field into one view range
+    int rangeViews[2] = {VIEW_PRICE, VIEW_DATE};
+    int rangeFields[2] = {FIELD_PRICE, FIELD_DATE};
+    for (int r = 0; r < 2; r++) {
+        int from = 0, to = views[rangeViews[r]].count, used = 0;
+        for (int p = 0; p < predicateCount; p++) {
+            if (predicates[p].field != rangeFields[r]) continue;
+            double key = predicates[p].number;
+            int lo = 0, hi = views[rangeViews[r]].count;
+            switch (predicates[p].op) {
+                case OP_EQ: lo = viewLowerBound(rangeViews[r], key, 0); hi = viewLowerBound(rangeViews[r], key, 1); break;
+                case OP_LT: hi = viewLowerBound(rangeViews[r], key, 0); break;
+                case OP_LE: hi = viewLowerBound(rangeViews[r], key, 1); break;
+                case OP_GT: lo = viewLowerBound(rangeViews[r], key, 1); break;
+                case OP_GE: lo = viewLowerBound(rangeViews[r], key, 0); break;
+            }
+            if (lo > from) from = lo;
+            if (hi < to) to = hi;
+            used = 1;
+        }
+        if (!used) continue;
+        if (to < from) to = from;
+        if (to - from > recordCount / 4) {
+            // Wide range: scanning the column beats walking the view slot by slot.
+            // The view range holds exactly the values between its end keys.
+            double lo = viewKey(rangeViews[r], views[rangeViews[r]].order[from]);
+            double hi = viewKey(rangeViews[r], views[rangeViews[r]].order[to - 1]);
+            if (r == 0) {
+                scanFloatRange(priceColumn, recordCount, (float)lo, 1, (float)hi, 1, &steps[stepCount]);
+            } else {
+                scanIntRange(dateKeyColumn, recordCount, (int)lo, (int)hi, &steps[stepCount]);
+            }
+            snprintf(scanNames[r], sizeof(scanNames[r]), "%s column scan (%s)",
+                     (r == 0) ? "price" : "date", scanLevelName());
+            stepNames[stepCount] = scanNames[r];
+        } else {
+            viewRangeToBitmap(rangeViews[r], from, to, &steps[stepCount]);
+            stepNames[stepCount] = (r == 0) ? "price view range" : "date view range";
+        }
+        stepSizes[stepCount] = to - from;
+        stepCount++;
+    }
+    
+    // ID: fold all predicates into one integer range for the column scan
+    int idLow = -1000000000, idHigh = 1000000000, idUsed = 0;
+    for (int p = 0; p < predicateCount; p++) {
+        if (predicates[p].field != FIELD_ID) continue;
+        double key = predicates[p].number;
+        if (key < -1000000000.0) key = -1000000000.0;
+        if (key > 1000000000.0) key = 1000000000.0;
+        int keyFloor = (int)key, keyCeil = (int)key;
+        if (keyFloor > key) keyFloor--;
+        if (keyCeil < key) keyCeil++;
+        switch (predicates[p].op) {
+            case OP_EQ: if (keyCeil > idLow) idLow = keyCeil; if (keyFloor < idHigh) idHigh = keyFloor; break;
+            case OP_LT: if (keyCeil - 1 < idHigh) idHigh = keyCeil - 1; break;
+            case OP_LE: if (keyFloor < idHigh) idHigh = keyFloor; break;
+            case OP_GT: if (keyFloor + 1 > idLow) idLow = keyFloor + 1; break;
+            case OP_GE: if (keyCeil > idLow) idLow = keyCeil; break;
         }
+        idUsed = 1;
+    }
+    if (idUsed) {
+        scanIntRange(idColumn, recordCount, idLow, idHigh, &steps[stepCount]);
+        stepSizes[stepCount] = bitmapCount(&steps[stepCount]);
+        snprintf(scanNames[2], sizeof(scanNames[2]), "id column scan (%s)", scanLevelName());
+        stepNames[stepCount] = scanNames[2];
+        stepCount++;
+    }
+    
+    for (int p = 0; p < predicateCount; p++) {
+        const QueryPredicate* q = &predicates[p];
+        residual[p] = 0;
         
-        // Add items based on quantity - auto-generate unique IDs for each item
-        for (int item = 0; item < itemsToAdd; item++) {
-            printf("\n--- Adding Item %d of %d ---\n", item + 1, itemsToAdd);
-            
-            // Auto-generate unique ID
-            newRecord.id = nextID + item;
-            
-            // Verify the generated ID is unique (in case of gaps)
-            while (!validateID(newRecord.id)) {
-                newRecord.id++;
+        if (q->field == FIELD_CATEGORY) {
+            CategoryIndexEntry* entry = findCategoryEntry(q->text, 0);
+            if (entry != NULL) {
+                steps[stepCount] = entry->members;
+            } else {
+                memset(&steps[stepCount], 0, sizeof(Bitmap));
             }
-            
-            // Update nextID for next iteration
-            nextID = newRecord.id + 1;
+            stepSizes[stepCount] = bitmapCount(&steps[stepCount]);
+            stepNames[stepCount] = "category bitmap";
+            stepCount++;
+        } else if (q->field == FIELD_NAME && strlen(q->text) >= 3 && !trigramIndexIncomplete) {
+            // Trigram candidates may include false positives, so keep the
+            // predicate as a residual check
+            Bitmap* candidates = &steps[stepCount];
+            int first = 1;
+            memset(candidates, 0, sizeof(Bitmap));
+            for (int t = 0; q->text[t + 2] != '\0'; t++) {
+                const PostingList* list = &trigramIndex[trigramBucket(&q->text[t])];
+                Bitmap listBits;
+                memset(&listBits, 0, sizeof(listBits));
+                for (int i = 0; i < list->count; i++) bitmapSet(&listBits, list->slots[i]);
+                for (int w = 0; w < BITMAP_WORDS; w++) {
+                    candidates->words[w] = first ? listBits.words[w] : (candidates->words[w] & listBits.words[w]);
+                }
+                first = 0;
+            }
+            stepSizes[stepCount] = bitmapCount(candidates);
+            stepNames[stepCount] = "name trigram index";
+            stepCount++;
+            residual[p] = 1;
+        } else if (q->field == FIELD_NAME) {
+            residual[p] = 1;
+        }
+    }
     
-            // Add record to array
-            records[recordCount] = newRecord;
-            recordCount++;
-            
-            printf("[OK] Item %d added successfully! (ID: %d)\n", item + 1, newRecord.id);
+    // Order index steps by selectivity (fewest candidates first)
+    for (int i = 1; i < stepCount; i++) {
+        for (int j = i; j > 0 && stepSizes[j] < stepSizes[j - 1]; j--) {
+            Bitmap tempBits = steps[j]; steps[j] = steps[j - 1]; steps[j - 1] = tempBits;
+            int tempSize = stepSizes[j]; stepSizes[j] = stepSizes[j - 1]; stepSizes[j - 1] = tempSize;
+            const char* tempName = stepNames[j]; stepNames[j] = stepNames[j - 1]; stepNames[j - 1] = tempName;
         }
+    }
     
-    // Save to file
-    saveToFile();
+    Bitmap result;
+    printf("\nExecution plan:\n");
+    if (stepCount == 0) {
+        // No index applies: every slot is a candidate for the scan
+        memset(&result, 0, sizeof(result));
+        for (int i = 0; i < recordCount; i++) bitmapSet(&result, i);
+        printf("  1. Full scan of %d record(s)\n", recordCount);
+    } else {
+        result = steps[0];
+        printf("  1. %s -> %d candidate(s)\n", stepNames[0], stepSizes[0]);
+        for (int st = 1; st < stepCount; st++) {
+            for (int w = 0; w < BITMAP_WORDS; w++) {
+                result.words[w] &= steps[st].words[w];
+            }
+            printf("  %d. AND %s (%d) -> %d candidate(s)\n", st + 1, stepNames[st], stepSizes[st], bitmapCount(&result));
+        }
+    }
     
-        printf("\n[OK] All %d record(s) inserted successfully!\n", itemsToAdd);
-        
-        // Ask if user wants to add more
-        printf("\nPress Enter to return to main menu, or type 'B' to add more items: ");
-        fflush(stdout);
-        char response[10];
-        if (fgets(response, sizeof(response), stdin) != NULL) {
-            response[strcspn(response, "\n")] = 0;
-            if (response[0] != 'B' && response[0] != 'b') {
-                break;  // Return to main menu
+    int residualCount = 0;
+    for (int p = 0; p < predicateCount; p++) residualCount += residual[p];
+    if (residualCount > 0) {
+        printf("  %d. Check %d remaining predicate(s) on each candidate\n", (stepCount == 0 ? 1 : stepCount) + 1, residualCount);
+    }
+    
+    *out = result;
+}
+
+
+// "and" in any case, followed by a space
+int isAndWord(const char* text) {
+    return tolower((unsigned char)text[0]) == 'a' && tolower((unsigned char)text[1]) == 'n' &&
+           tolower((unsigned char)text[2]) == 'd' && text[3] == ' ';
+}
+
+// Start of the "field op" right after a separator, or NULL if text does not
+// begin with one (the separator is then part of a value)
+char* predicateAfter(char* text) {
+    char field[20];
+    int length = 0;
+    
+    while (*text == ' ') text++;
+    char* start = text;
+    while (isalpha((unsigned char)*text) && length < (int)sizeof(field) - 1) {
+        field[length++] = (char)tolower((unsigned char)*text++);
+    }
+    field[length] = '\0';
+    while (*text == ' ') text++;
+    
+    if (queryFieldNamed(field) == 0 || *text == '\0' || strchr("<>=~", *text) == NULL) return NULL;
+    return start;
+}
+
+// Split on AND (any case) or ',' (or both, as in ", and") and parse each
+// predicate. A separator only counts when a "field op" follows it, so names
+// such as "Keyboard and Trackpad" can be used as values
+int parseQuery(const char* text, QueryPredicate* predicates, int* count) {
+    char buffer[MAX_QUERY_LENGTH];
+    char* start = buffer;
+    
+    strncpy(buffer, text, sizeof(buffer) - 1);
+    buffer[sizeof(buffer) - 1] = '\0';
+    *count = 0;
+    
+    while (1) {
+        char* end = start;
+        char* next = NULL;
+        while (*end != '\0') {
+            if (*end == ',') {
+                char* after = end + 1;
+                while (*after == ' ') after++;
+                next = predicateAfter(isAndWord(after) ? after + 3 : end + 1);
+                if (next != NULL) break;
             }
-        } else {
-            break;
+            if ((end == start || end[-1] == ' ') && isAndWord(end)) {
+                next = predicateAfter(end + 3);
+                if (next != NULL) break;
+            }
+            end++;
+        }
+        char saved = *end;
+        *end = '\0';
+        
+        if (*count >= MAX_QUERY_PREDICATES) {
+            printf("[ERROR] Too many conditions (max %d)!\n", MAX_QUERY_PREDICATES);
+            return 0;
+        }
+        if (!parsePredicate(start, &predicates[*count])) {
+            return 0;
+        }
+        (*count)++;
+        
+        if (saved == '\0' || next == NULL) break;
+        start = next;
+    }
+    return 1;
+}
+
+// FIELD_* for a lowercased field name, or 0 if there is no such field
+int queryFieldNamed(const char* name) {
+    if (strcmp(name, "id") == 0) return FIELD_ID;
+    if (strcmp(name, "price") == 0) return FIELD_PRICE;
+    if (strcmp(name, "date") == 0) return FIELD_DATE;
+    if (strcmp(name, "name") == 0) return FIELD_NAME;
+    if (strcmp(name, "category") == 0) return FIELD_CATEGORY;
+    return 0;
+}
+
+// Parse "field op value"; prints the problem and returns 0 if invalid
+int parsePredicate(char* text, QueryPredicate* predicate) {
+    char field[20];
+    int length = 0;
+    
+    while (*text == ' ') text++;
+    while (isalpha((unsigned char)*text) && length < (int)sizeof(field) - 1) {
+        field[length++] = (char)tolower((unsigned char)*text++);
+    }
+    field[length] = '\0';
+    while (*text == ' ') text++;
+    
+    predicate->field = queryFieldNamed(field);
+    if (predicate->field == 0) {
+        printf("[ERROR] Unknown field '%s'!\n", field);
+        return 0;
+    }
+    
+    if (text[0] == '<' && text[1] == '=') { predicate->op = OP_LE; text += 2; }
+    else if (text[0] == '>' && text[1] == '=') { predicate->op = OP_GE; text += 2; }
+    else if (text[0] == '<') { predicate->op = OP_LT; text++; }
+    else if (text[0] == '>') { predicate->op = OP_GT; text++; }
+    else if (text[0] == '=') { predicate->op = OP_EQ; text++; }
+    else if (text[0] == '~') { predicate->op = OP_CONTAINS; text++; }
+    else {
+        printf("[ERROR] Missing operator after '%s'!\n", field);
+        return 0;
+    }
+    
+    // Trim the value
+    while (*text == ' ') text++;
+    char* end = text + strlen(text);
+    while (end > text && end[-1] == ' ') *--end = '\0';
+    if (*text == '\0') {
+        printf("[ERROR] Missing value for '%s'!\n", field);
+        return 0;
+    }
+    
+    if (predicate->field == FIELD_NAME || predicate->field == FIELD_CATEGORY) {
+        if (predicate->op != OP_EQ && !(predicate->field == FIELD_NAME && predicate->op == OP_CONTAINS)) {
+            printf("[ERROR] '%s' only supports %s!\n", field, predicate->field == FIELD_NAME ? "= and ~" : "=");
+            return 0;
+        }
+        toLowerCase(text, predicate->text, sizeof(predicate->text));
+        predicate->hash = foldedHash(predicate->text);
+    } else if (predicate->op == OP_CONTAINS) {
+        printf("[ERROR] '~' only applies to name!\n");
+        return 0;
+    } else if (predicate->field == FIELD_DATE) {
+        if (!validateDate(text)) return 0;
+        predicate->number = dateToKey(text);
+    } else {
+        char* numberEnd;
+        predicate->number = strtod(text, &numberEnd);
+        if (numberEnd == text || *numberEnd != '\0') {
+            printf("[ERROR] '%s' is not a number!\n", text);
+            return 0;
+        }
+        if (predicate->field == FIELD_PRICE) {
+            predicate->number = (float)predicate->number;  // Compare at stored precision
         }
     }
-}
-
-// 2. DISPLAY ALL RECORDS
-void displayAllRecords() {
-    printf("\n==============================================================\n");
-    printf("              ALL RECORDS                                     \n");
-    printf("==============================================================\n\n");
+    return 1;
+}
+
+// Evaluate one predicate directly against records[slot]
+int predicateMatches(const QueryPredicate* predicate, int slot) {
+    double value;
+    
+    if (predicate->field == FIELD_NAME || predicate->field == FIELD_CATEGORY) {
+        const char* folded = (predicate->field == FIELD_NAME) ? nameFoldedColumn[slot] : categoryFoldedColumn[slot];
+        unsigned int hash = (predicate->field == FIELD_NAME) ? nameHashColumn[slot] : categoryHashColumn[slot];
+        if (predicate->op == OP_CONTAINS) return strstr(folded, predicate->text) != NULL;
+        return hash == predicate->hash && strcmp(folded, predicate->text) == 0;
+    }
+    
+    if (predicate->field == FIELD_ID) value = records[slot].id;
+    else if (predicate->field == FIELD_PRICE) value = records[slot].price;
+    else value = dateToKey(records[slot].date);
+    
+    switch (predicate->op) {
+        case OP_EQ: return value == predicate->number;
+        case OP_LT: return value < predicate->number;
+        case OP_LE: return value <= predicate->number;
+        case OP_GT: return value > predicate->number;
+        case OP_GE: return value >= predicate->number;
+    }
+    return 0;
+}
+
+// Helper to convert string to lowercase safely
+void toLowerCase(const char* src, char* dest, size_t size) {
+    size_t i;
+    if (size == 0) return;
+    for (i = 0; i + 1 < size && src[i] != '\0'; i++) {
+        dest[i] = (char)tolower((unsigned char)src[i]);
+    }
+    dest[i] = '\0';
+}
+
+// 4. DELETE A RECORD BY ID
+void deleteByID() {
+    int deleteID;
+    int found = 0;
+    int index = -1;
+    
+    printf("\n==============================================================\n");
+    printf("              DELETE RECORD BY ID                             \n");
+    printf("==============================================================\n\n");
+    
+    if (recordCount == 0) {
+        printf("[ERROR] No records to delete!\n");
+        return;
+    }
+    
+    printf("Enter Product ID to delete: ");
+    fflush(stdout);
+    if (scanf("%d", &deleteID) != 1) {
+        clearInputBuffer();
+        printf("[ERROR] Invalid ID format!\n");
+        return;
+    }
     
-    if (recordCount == 0) {
-        printf("No records found in the system.\n");
+    clearInputBuffer();
+    
+    // Find the record
+    index = findSlotByID(deleteID);
+    found = (index >= 0);
+    
+    if (!found) {
+        printf("\n[ERROR] Record with ID %d not found!\n", deleteID);
         return;
     }
     
-    // Display table header
-    printf("+------------+--------------------------------------+------------+------------+------------+\n");
-    printf("| Product ID | Product Name                         | Price      | Date       | Category   |\n");
-    printf("+------------+--------------------------------------+------------+------------+------------+\n");
+    // Display record to be deleted
+    printf("\n[WARNING] Record to be deleted:\n");
+    printf("+--------------------------------------------------------+\n");
+    printf("| Product ID    : %-40d |\n", records[index].id);
+    printf("| Product Name  : %-40s |\n", records[index].productName);
+    printf("| Price         : $%-38.2f |\n", records[index].price);
+    printf("| Date          : %-40s |\n", records[index].date);
+    printf("| Category      : %-40s |\n", records[index].category);
+    printf("+--------------------------------------------------------+\n");
     
-    // Display all records
-    for (int i = 0; i < recordCount; i++) {
-        printf("| %-10d | %-36s | $%-9.2f | %-10s | %-10s |\n", 
-               records[i].id, records[i].productName, 
-               records[i].price, records[i].date, records[i].category);
+    // Drop the record from secondary indexes before slots shift down
+    indexDeleteRecord(index);
+    
+    // Shift all elements after the deleted one
+    for (int i = index; i < recordCount - 1; i++) {
+        records[i] = records[i + 1];
     }
     
-    printf("+------------+--------------------------------------+------------+------------+------------+\n");
-    printf("\nTotal Records: %d\n", recordCount);
+    recordCount--;
+    saveToFile();
+    
+    printf("\n[OK] Record deleted successfully!\n");
+    printf("   Remaining records: %d\n", recordCount);
 }
 
-// 3. SEARCH MENU - Allows user to choose search criteria
-void searchMenu() {
-    int choice;
+// 5. SORT RECORDS - Shows sub-menu for sorting options
+void sortRecords() {
+    int sortChoice;
+    
+    if (recordCount == 0) {
+        printf("\n[ERROR] No records to sort!\n");
+        return;
+    }
     
     while (1) {
-        printf("\n==============================================================\n");
-        printf("                    SEARCH MENU                               \n");
-        printf("--------------------------------------------------------------\n");
-        printf("  1. Search by ID                                            \n");
-        printf("  2. Search by Date                                          \n");
-        printf("  3. Search by Name                                          \n");
-        printf("  4. Search by Category                                      \n");
-        printf("  5. Back to Main Menu                                       \n");
-        printf("==============================================================\n");
+        displaySortMenu();
         printCenteredNoNL("Enter your choice (1-5): ");
         fflush(stdout);
         
-        if (scanf("%d", &choice) != 1) {
+        if (scanf("%d", &sortChoice) != 1) {
             clearInputBuffer();
             printf("[ERROR] Invalid input! Please enter a number.\n");
             printf("Press Enter to continue...");
@@ -939,18 +4972,18 @@ void searchMenu() {
         
         clearInputBuffer();
         
-        switch(choice) {
+        switch(sortChoice) {
             case 1:
-                searchByID();
+                sortByPriceAscending();
                 return;
             case 2:
-                searchByDate();
+                sortByPriceDescending();
                 return;
             case 3:
-                searchByName();
+                sortByDateAscending();
                 return;
             case 4:
-                searchByCategory();
+                sortByDateDescending();
                 return;
             case 5:
                 return;  // Back to main menu
@@ -963,708 +4996,1305 @@ void searchMenu() {
     }
 }
 
-// SEARCH FOR A RECORD BY ID
-void searchByID() {
-    int searchID;
-    int found = 0;
+// Display sorting sub-menu
+void displaySortMenu() {
+    printf("\n==============================================================\n");
+    printf("                    SORT RECORDS                               \n");
+    printf("--------------------------------------------------------------\n");
+    printf("  1. Sort by Price (Ascending - Lowest to Highest)           \n");
+    printf("  2. Sort by Price (Descending - Highest to Lowest)         \n");
+    printf("  3. Sort by Date (Ascending - Oldest to Newest)            \n");
+    printf("  4. Sort by Date (Descending - Newest to Oldest)           \n");
+    printf("  5. Back to Main Menu                                       \n");
+    printf("==============================================================\n");
+}
+
+// Helper function to compare dates (DD/MM/YYYY format)
+// Returns: -1 if date1 < date2, 0 if equal, 1 if date1 > date2
+int compareDates(char* date1, char* date2) {
+    int day1, month1, year1;
+    int day2, month2, year2;
+    
+    // Parse date1 (DD/MM/YYYY)
+    if (sscanf(date1, "%d/%d/%d", &day1, &month1, &year1) != 3) {
+        return 0;  // Invalid date format
+    }
+    
+    // Parse date2 (DD/MM/YYYY)
+    if (sscanf(date2, "%d/%d/%d", &day2, &month2, &year2) != 3) {
+        return 0;  // Invalid date format
+    }
+    
+    // Compare years
+    if (year1 < year2) return -1;
+    if (year1 > year2) return 1;
+    
+    // Compare months
+    if (month1 < month2) return -1;
+    if (month1 > month2) return 1;
+    
+    // Compare days
+    if (day1 < day2) return -1;
+    if (day1 > day2) return 1;
     
+    return 0;  // Dates are equal
+}
+
+// Sort by Price (Ascending - Bubble Sort)
+void sortByPriceAscending() {
     printf("\n==============================================================\n");
-    printf("              SEARCH RECORD BY ID                             \n");
+    printf("     SORTING RECORDS BY PRICE (Ascending)                     \n");
     printf("==============================================================\n\n");
     
-    printf("Enter Product ID to search: ");
-    fflush(stdout);
-    if (scanf("%d", &searchID) != 1) {
-        clearInputBuffer();
-        printf("[ERROR] Invalid ID format!\n");
-        return;
+    // Bubble Sort Algorithm
+    Record temp;
+    int swapped;
+    
+    for (int i = 0; i < recordCount - 1; i++) {
+        swapped = 0;
+        for (int j = 0; j < recordCount - i - 1; j++) {
+            if (records[j].price > records[j + 1].price) {
+                temp = records[j];
+                records[j] = records[j + 1];
+                records[j + 1] = temp;
+                swapped = 1;
+            }
+        }
+        if (!swapped) break;  // Early exit if sorted
     }
     
-    clearInputBuffer();
+    rebuildIndexes();
+    saveToFile();
     
-    // Search for the record
-    for (int i = 0; i < recordCount; i++) {
-        if (records[i].id == searchID) {
-            printf("\n[OK] Record Found!\n");
-            printf("+--------------------------------------------------------+\n");
-            printf("| Product ID    : %-40d |\n", records[i].id);
-            printf("| Product Name  : %-40s |\n", records[i].productName);
-            printf("| Price         : $%-38.2f |\n", records[i].price);
-            printf("| Date          : %-40s |\n", records[i].date);
-            printf("| Category      : %-40s |\n", records[i].category);
-            printf("+--------------------------------------------------------+\n");
-            found = 1;
-            break;
+    printf("[OK] Records sorted successfully by Price (Ascending)!\n");
+    printf("   Algorithm: Bubble Sort\n");
+    printf("   Order: Lowest -> Highest (by Price)\n\n");
+    
+    displayAllRecords();
+}
+
+// Sort by Price (Descending - Selection Sort)
+void sortByPriceDescending() {
+    printf("\n==============================================================\n");
+    printf("     SORTING RECORDS BY PRICE (Descending)                    \n");
+    printf("==============================================================\n\n");
+    
+    // Selection Sort Algorithm
+    Record temp;
+    int maxIndex;
+    
+    for (int i = 0; i < recordCount - 1; i++) {
+        maxIndex = i;
+        for (int j = i + 1; j < recordCount; j++) {
+            if (records[j].price > records[maxIndex].price) {
+                maxIndex = j;
+            }
+        }
+        if (maxIndex != i) {
+            temp = records[i];
+            records[i] = records[maxIndex];
+            records[maxIndex] = temp;
         }
     }
     
-    if (!found) {
-        printf("\n[ERROR] Record with ID %d not found!\n", searchID);
-    }
+    rebuildIndexes();
+    saveToFile();
+    
+    printf("[OK] Records sorted successfully by Price (Descending)!\n");
+    printf("   Algorithm: Selection Sort\n");
+    printf("   Order: Highest -> Lowest (by Price)\n\n");
+    
+    displayAllRecords();
 }
 
-// SEARCH FOR RECORDS BY DATE
-void searchByDate() {
-    char searchDate[MAX_DATE_LENGTH];
-    int found = 0;
-    int foundCount = 0;
-    
+// Sort by Date (Ascending - Bubble Sort)
+void sortByDateAscending() {
     printf("\n==============================================================\n");
-    printf("              SEARCH RECORD BY DATE                           \n");
+    printf("     SORTING RECORDS BY DATE (Ascending)                      \n");
     printf("==============================================================\n\n");
     
-    printf("Enter Date to search (DD/MM/YYYY): ");
-    fflush(stdout);
-    if (fgets(searchDate, MAX_DATE_LENGTH, stdin) == NULL) {
-        printf("[ERROR] Failed to read date!\n");
-        return;
+    // Bubble Sort Algorithm
+    Record temp;
+    int swapped;
+    
+    for (int i = 0; i < recordCount - 1; i++) {
+        swapped = 0;
+        for (int j = 0; j < recordCount - i - 1; j++) {
+            if (compareDates(records[j].date, records[j + 1].date) > 0) {
+                temp = records[j];
+                records[j] = records[j + 1];
+                records[j + 1] = temp;
+                swapped = 1;
+            }
+        }
+        if (!swapped) break;  // Early exit if sorted
     }
     
-    // Remove newline character
-    searchDate[strcspn(searchDate, "\n")] = 0;
+    rebuildIndexes();
+    saveToFile();
     
-    // Validate date format
-    if (!validateDate(searchDate)) {
-        return;
-    }
+    printf("[OK] Records sorted successfully by Date (Ascending)!\n");
+    printf("   Algorithm: Bubble Sort\n");
+    printf("   Order: Oldest -> Newest (by Date)\n\n");
     
-    // Search for records matching the date
-    printf("\nSearching for records with date: %s\n", searchDate);
-    printf("+------------+--------------------------------------+------------+------------+------------+\n");
-    printf("| Product ID | Product Name                         | Price      | Date       | Category   |\n");
-    printf("+------------+--------------------------------------+------------+------------+------------+\n");
+    displayAllRecords();
+}
+
+// Sort by Date (Descending - Selection Sort)
+void sortByDateDescending() {
+    printf("\n==============================================================\n");
+    printf("     SORTING RECORDS BY DATE (Descending)                     \n");
+    printf("==============================================================\n\n");
     
-    for (int i = 0; i < recordCount; i++) {
-        if (strcmp(records[i].date, searchDate) == 0) {
-            printf("| %-10d | %-36s | $%-9.2f | %-10s | %-10s |\n", 
-                   records[i].id, records[i].productName, 
-                   records[i].price, records[i].date, records[i].category);
-            found = 1;
-            foundCount++;
+    // Selection Sort Algorithm
+    Record temp;
+    int maxIndex;
+    
+    for (int i = 0; i < recordCount - 1; i++) {
+        maxIndex = i;
+        for (int j = i + 1; j < recordCount; j++) {
+            if (compareDates(records[j].date, records[maxIndex].date) > 0) {
+                maxIndex = j;
+            }
+        }
+        if (maxIndex != i) {
+            temp = records[i];
+            records[i] = records[maxIndex];
+            records[maxIndex] = temp;
         }
     }
     
-    printf("+------------+--------------------------------------+------------+------------+------------+\n");
+    rebuildIndexes();
+    saveToFile();
+    
+    printf("[OK] Records sorted successfully by Date (Descending)!\n");
+    printf("   Algorithm: Selection Sort\n");
+    printf("   Order: Newest -> Oldest (by Date)\n\n");
     
-    if (!found) {
-        printf("\n[ERROR] No records found with date %s!\n", searchDate);
-    } else {
-        printf("\n[OK] Found %d record(s) with date %s!\n", foundCount, searchDate);
-    }
+    displayAllRecords();
 }
 
-// SEARCH FOR RECORDS BY NAME
-void searchByName() {
-    char searchName[MAX_NAME_LENGTH];
+// 6. UPDATE AN EXISTING RECORD
+void updateRecord() {
+    int updateID;
     int found = 0;
-    int foundCount = 0;
+    int index = -1;
+    int choice;
+    float newPrice;
+    char newDate[MAX_DATE_LENGTH];
+    Record before;
     
     printf("\n==============================================================\n");
-    printf("              SEARCH RECORD BY NAME                           \n");
+    printf("              UPDATE RECORD                                 \n");
     printf("==============================================================\n\n");
     
-    printf("Enter Product Name to search: ");
+    printf("Enter Product ID to update: ");
     fflush(stdout);
-    if (fgets(searchName, MAX_NAME_LENGTH, stdin) == NULL) {
-        printf("[ERROR] Failed to read product name!\n");
+    if (scanf("%d", &updateID) != 1) {
+        clearInputBuffer();
+        printf("[ERROR] Invalid ID format!\n");
         return;
     }
     
-    // Remove newline character
-    searchName[strcspn(searchName, "\n")] = 0;
+    clearInputBuffer();
     
-    if (strlen(searchName) == 0) {
-        printf("[ERROR] Product name cannot be empty!\n");
+    // Find the record
+    index = findSlotByID(updateID);
+    found = (index >= 0);
+    
+    if (!found) {
+        printf("\n[ERROR] Record with ID %d not found!\n", updateID);
         return;
     }
     
-    // Search for records matching the name (case-insensitive partial match)
-    printf("\nSearching for records containing: %s\n", searchName);
-    printf("+------------+--------------------------------------+------------+------------+------------+\n");
-    printf("| Product ID | Product Name                         | Price      | Date       | Category   |\n");
-    printf("+------------+--------------------------------------+------------+------------+------------+\n");
+    // Display current record
+    printf("\nCurrent Record Details:\n");
+    printf("+--------------------------------------------------------+\n");
+    printf("| Product ID    : %-40d |\n", records[index].id);
+    printf("| Product Name  : %-40s |\n", records[index].productName);
+    printf("| Price         : $%-38.2f |\n", records[index].price);
+    printf("| Date          : %-40s |\n", records[index].date);
+    printf("| Category      : %-40s |\n", records[index].category);
+    printf("+--------------------------------------------------------+\n");
     
-    for (int i = 0; i < recordCount; i++) {
-        // Case-insensitive search using strstr
-        if (strstr(records[i].productName, searchName) != NULL) {
-            printf("| %-10d | %-36s | $%-9.2f | %-10s | %-10s |\n", 
-                   records[i].id, records[i].productName, 
-                   records[i].price, records[i].date, records[i].category);
-            found = 1;
-            foundCount++;
-        }
+    before = records[index];
+    
+    // Get update choice
+    printf("\nWhat would you like to update?\n");
+    printf("  1. Price\n");
+    printf("  2. Date\n");
+    printf("  3. Both (Price and Date)\n");
+    printf("Enter choice (1-3): ");
+    fflush(stdout);
+    
+    if (scanf("%d", &choice) != 1) {
+        clearInputBuffer();
+        printf("[ERROR] Invalid choice!\n");
+        return;
     }
     
-    printf("+------------+--------------------------------------+------------+------------+------------+\n");
+    clearInputBuffer();
     
-    if (!found) {
-        printf("\n[ERROR] No records found containing '%s'!\n", searchName);
-    } else {
-        printf("\n[OK] Found %d record(s) containing '%s'!\n", foundCount, searchName);
+    // Process update
+    switch(choice) {
+        case 1:
+            printf("Enter new Price ($): ");
+            fflush(stdout);
+            if (scanf("%f", &newPrice) != 1) {
+                clearInputBuffer();
+                printf("[ERROR] Invalid price format!\n");
+                return;
+            }
+            if (!validatePrice(newPrice)) {
+                return;
+            }
+            records[index].price = newPrice;
+            break;
+            
+        case 2:
+            printf("Enter new Date (DD/MM/YYYY): ");
+            fflush(stdout);
+            if (fgets(newDate, MAX_DATE_LENGTH, stdin) == NULL) {
+                printf("[ERROR] Failed to read date!\n");
+                return;
+            }
+            newDate[strcspn(newDate, "\n")] = 0;
+            if (!validateDate(newDate)) {
+                return;
+            }
+            strcpy(records[index].date, newDate);
+            break;
+            
+        case 3:
+            printf("Enter new Price ($): ");
+            fflush(stdout);
+            if (scanf("%f", &newPrice) != 1) {
+                clearInputBuffer();
+                printf("[ERROR] Invalid price format!\n");
+                return;
+            }
+            if (!validatePrice(newPrice)) {
+                return;
+            }
+            
+                clearInputBuffer();
+            printf("Enter new Date (DD/MM/YYYY): ");
+            fflush(stdout);
+            if (fgets(newDate, MAX_DATE_LENGTH, stdin) == NULL) {
+                printf("[ERROR] Failed to read date!\n");
+                return;
+            }
+            newDate[strcspn(newDate, "\n")] = 0;
+            if (!validateDate(newDate)) {
+                return;
+            }
+            // Apply both fields only once both are valid
+            records[index].price = newPrice;
+            strcpy(records[index].date, newDate);
+            break;
+            
+        default:
+            printf("[ERROR] Invalid choice!\n");
+            return;
     }
+    
+    clearInputBuffer();
+    indexUpdateRecord(index, &before);
+    saveToFile();
+    
+    printf("\n[OK] Record updated successfully!\n");
+    printf("+--------------------------------------------------------+\n");
+    printf("| Product ID    : %-40d |\n", records[index].id);
+    printf("| Product Name  : %-40s |\n", records[index].productName);
+    printf("| Price         : $%-38.2f |\n", records[index].price);
+    printf("| Date          : %-40s |\n", records[index].date);
+    printf("| Category      : %-40s |\n", records[index].category);
+    printf("+--------------------------------------------------------+\n");
 }
 
-// SEARCH FOR RECORDS BY CATEGORY
-void searchByCategory() {
-    char searchCategory[20];
-    char categoryLower[20];
-    char recordLower[20];
-    int found = 0;
-    int foundCount = 0;
+// 7. EXPORT STOCK REPORT
+void exportReport() {
+    FILE *reportFile;
+    char filename[100];
+    int threadsUsed = 1;
+    time_t t = time(NULL);
+    struct tm *tm_info = localtime(&t);
     
-    printf("\n==============================================================\n");
-    printf("            SEARCH RECORD BY CATEGORY                         \n");
-    printf("==============================================================\n\n");
+    // Generate filename with timestamp
+    sprintf(filename, "apple_store_report_%04d%02d%02d_%02d%02d%02d.txt",
+            tm_info->tm_year + 1900, tm_info->tm_mon + 1, tm_info->tm_mday,
+            tm_info->tm_hour, tm_info->tm_min, tm_info->tm_sec);
     
-    printf("Enter Category to search (e.g., iPhones, MacBooks, iWatch): ");
-    fflush(stdout);
-    if (fgets(searchCategory, sizeof(searchCategory), stdin) == NULL) {
-        printf("[ERROR] Failed to read category!\n");
+    reportFile = fopen(filename, "w");
+    
+    if (reportFile == NULL) {
+        printf("[ERROR] Cannot create report file!\n");
         return;
     }
     
-    searchCategory[strcspn(searchCategory, "\n")] = 0;
+    // Write report header
+    fprintf(reportFile, "==============================================================\n");
+    fprintf(reportFile, "            MY APPLE-STORE SYSTEM                             \n");
+    fprintf(reportFile, "              STOCK REPORT                                    \n");
+    fprintf(reportFile, "==============================================================\n\n");
+    fprintf(reportFile, "Generated on: %s", asctime(tm_info));
+    fprintf(reportFile, "Total Records: %d\n\n", recordCount);
     
-    if (strlen(searchCategory) == 0) {
-        printf("[ERROR] Category cannot be empty!\n");
-        return;
+    if (recordCount == 0) {
+        fprintf(reportFile, "No records in stock.\n");
+    } else {
+        // Write table header
+        fprintf(reportFile, "+------------+--------------------------------------+------------+------------+------------+\n");
+        fprintf(reportFile, "| Product ID | Product Name                         | Price      | Date       | Category   |\n");
+        fprintf(reportFile, "+------------+--------------------------------------+------------+------------+------------+\n");
+        
+        // Write all records; the same pass fills the product, month and price
+        // band groupings (categories come from the running totals)
+        static const int reportGroupings[] = {GROUP_BY_PRODUCT, GROUP_BY_MONTH, GROUP_BY_PRICE_BAND};
+        threadsUsed = writeReportRows(reportFile, reportGroupings, 3);
+        
+        fprintf(reportFile, "+------------+--------------------------------------+------------+------------+------------+\n");
+        
+        writeCategoryTotals(reportFile);
+        writePriceDistribution(reportFile);
+        writeGroupSummary(reportFile, "PRODUCT", &reportGroups[GROUP_BY_PRODUCT]);
+        writeGroupSummary(reportFile, "MONTH", &reportGroups[GROUP_BY_MONTH]);
+        writeGroupSummary(reportFile, "PRICE BAND", &reportGroups[GROUP_BY_PRICE_BAND]);
+        
+        double totalValue = 0;
+        for (int c = 0; c < categoryTotalCount; c++) {
+            totalValue += categoryTotals[c].value;
+        }
+        fprintf(reportFile, "--------------------------------------------------------------\n");
+        fprintf(reportFile, "TOTAL    : %d items, Total Value: $%.2f\n", recordCount, totalValue);
     }
     
-    toLowerCase(searchCategory, categoryLower, sizeof(categoryLower));
+    fclose(reportFile);
     
-    printf("\nSearching for records in category: %s\n", searchCategory);
-    printf("+------------+--------------------------------------+------------+------------+------------+\n");
-    printf("| Product ID | Product Name                         | Price      | Date       | Category   |\n");
-    printf("+------------+--------------------------------------+------------+------------+------------+\n");
+    printf("\n[OK] Stock report exported successfully!\n");
+    printf("   File: %s\n", filename);
+    printf("   Threads: %d\n", threadsUsed);
+}
+
+// ============================================================================
+// MACHINE-READABLE EXPORTS
+// ============================================================================
+// CSV and JSON Lines rows are formatted straight into the row buffer and
+// flushed to the file in large chunks; the columnar export writes the column
+// arrays as they are. Files are opened in binary mode so the bytes are the
+// same on every platform (LF line endings).
+
+// RFC 4180 field: quoted, with quotes doubled, only when it needs to be
+size_t appendCsvField(char* out, const char* text) {
+    if (strpbrk(text, ",\"\r\n") == NULL) return appendPaddedText(out, text, 0);
+    
+    size_t length = 0;
+    out[length++] = '"';
+    for (const char* c = text; *c; c++) {
+        if (*c == '"') out[length++] = '"';
+        out[length++] = *c;
+    }
+    out[length++] = '"';
+    return length;
+}
+
+size_t appendJsonString(char* out, const char* text) {
+    static const char hex[] = "0123456789abcdef";
+    size_t length = 0;
+    out[length++] = '"';
+    for (const unsigned char* c = (const unsigned char*)text; *c; c++) {
+        if (*c == '"' || *c == '\\') {
+            out[length++] = '\\';
+            out[length++] = (char)*c;
+        } else if (*c < 0x20) {
+            length += appendPaddedText(out + length, "\\u00", 0);
+            out[length++] = hex[*c >> 4];
+            out[length++] = hex[*c & 15];
+        } else {
+            out[length++] = (char)*c;
+        }
+    }
+    out[length++] = '"';
+    return length;
+}
+
+// YYYY-MM-DD from a YYYYMMDD key
+size_t appendIsoDate(char* out, int key) {
+    size_t length = appendPaddedInt(out, key / 10000, 0);
+    out[length++] = '-';
+    out[length++] = (char)('0' + key / 1000 % 10);
+    out[length++] = (char)('0' + key / 100 % 10);
+    out[length++] = '-';
+    out[length++] = (char)('0' + key / 10 % 10);
+    out[length++] = (char)('0' + key % 10);
+    return length;
+}
+
+// id,product_name,price,date,category; a malformed date is left empty
+int writeCsvExport(FILE* file) {
+    setRowOutput(file);
+    char* out = reserveOutput(EXPORT_ROW_LENGTH);
+    rowBufferLength += appendPaddedText(out, "id,product_name,price,date,category\n", 0);
     
     for (int i = 0; i < recordCount; i++) {
-        toLowerCase(records[i].category, recordLower, sizeof(recordLower));
-        if (strcmp(recordLower, categoryLower) == 0) {
-            printf("| %-10d | %-36s | $%-9.2f | %-10s | %-10s |\n", 
-                   records[i].id, records[i].productName, 
-                   records[i].price, records[i].date, records[i].category);
-            found = 1;
-            foundCount++;
-        }
+        out = reserveOutput(EXPORT_ROW_LENGTH);
+        size_t length = appendPaddedInt(out, records[i].id, 0);
+        out[length++] = ',';
+        length += appendCsvField(out + length, records[i].productName);
+        out[length++] = ',';
+        length += appendPaddedMoney(out + length, records[i].price, 0);
+        out[length++] = ',';
+        if (dateKeyColumn[i] != 0) length += appendIsoDate(out + length, dateKeyColumn[i]);
+        out[length++] = ',';
+        length += appendCsvField(out + length, records[i].category);
+        out[length++] = '\n';
+        rowBufferLength += length;
     }
     
-    printf("+------------+--------------------------------------+------------+------------+------------+\n");
+    setRowOutput(NULL);
+    return recordCount;
+}
+
+// One object per line; a malformed date is written as null
+int writeJsonLinesExport(FILE* file) {
+    setRowOutput(file);
     
-    if (!found) {
-        printf("\n[ERROR] No records found in category '%s'!\n", searchCategory);
-    } else {
-        printf("\n[OK] Found %d record(s) in category '%s'!\n", foundCount, searchCategory);
+    for (int i = 0; i < recordCount; i++) {
+        char* out = reserveOutput(EXPORT_ROW_LENGTH);
+        size_t length = appendPaddedText(out, "{\"id\":", 0);
+        length += appendPaddedInt(out + length, records[i].id, 0);
+        length += appendPaddedText(out + length, ",\"product_name\":", 0);
+        length += appendJsonString(out + length, records[i].productName);
+        length += appendPaddedText(out + length, ",\"price\":", 0);
+        length += appendPaddedMoney(out + length, records[i].price, 0);
+        length += appendPaddedText(out + length, ",\"date\":", 0);
+        if (dateKeyColumn[i] != 0) {
+            out[length++] = '"';
+            length += appendIsoDate(out + length, dateKeyColumn[i]);
+            out[length++] = '"';
+        } else {
+            length += appendPaddedText(out + length, "null", 0);
+        }
+        length += appendPaddedText(out + length, ",\"category\":", 0);
+        length += appendJsonString(out + length, records[i].category);
+        length += appendPaddedText(out + length, "}\n", 0);
+        rowBufferLength += length;
     }
+    
+    setRowOutput(NULL);
+    return recordCount;
 }
 
-// Helper to convert string to lowercase safely
-void toLowerCase(const char* src, char* dest, size_t size) {
-    size_t i;
-    if (size == 0) return;
-    for (i = 0; i + 1 < size && src[i] != '\0'; i++) {
-        dest[i] = (char)tolower((unsigned char)src[i]);
+// Little-endian, whatever the host byte order
+void writeUint32(FILE* file, unsigned int value) {
+    unsigned char bytes[4] = {
+        (unsigned char)value, (unsigned char)(value >> 8),
+        (unsigned char)(value >> 16), (unsigned char)(value >> 24)
+    };
+    fwrite(bytes, 1, 4, file);
+}
+
+// count 4-byte values (ints, or floats as their bit patterns) in little-endian
+// order, encoded a chunk at a time
+void writeWordColumn(FILE* file, const void* values, int count) {
+    unsigned char chunk[1024];
+    size_t length = 0;
+    
+    for (int i = 0; i < count; i++) {
+        unsigned int value;
+        memcpy(&value, (const unsigned char*)values + 4 * (size_t)i, 4);
+        chunk[length++] = (unsigned char)value;
+        chunk[length++] = (unsigned char)(value >> 8);
+        chunk[length++] = (unsigned char)(value >> 16);
+        chunk[length++] = (unsigned char)(value >> 24);
+        if (length == sizeof(chunk)) {
+            fwrite(chunk, 1, length, file);
+            length = 0;
+        }
     }
-    dest[i] = '\0';
+    fwrite(chunk, 1, length, file);
 }
 
-// 4. DELETE A RECORD BY ID
-void deleteByID() {
-    int deleteID;
-    int found = 0;
-    int index = -1;
-    
-    printf("\n==============================================================\n");
-    printf("              DELETE RECORD BY ID                             \n");
-    printf("==============================================================\n\n");
-    
-    if (recordCount == 0) {
-        printf("[ERROR] No records to delete!\n");
-        return;
+void writeColumnHeader(FILE* file, const char* name, unsigned int type, unsigned int byteLength) {
+    char padded[COLUMNAR_NAME_LENGTH] = {0};
+    strncpy(padded, name, COLUMNAR_NAME_LENGTH - 1);
+    fwrite(padded, 1, COLUMNAR_NAME_LENGTH, file);
+    writeUint32(file, type);
+    writeUint32(file, byteLength);
+}
+
+// String column: recordCount + 1 end offsets, then the bytes without terminators
+void writeStringColumn(FILE* file, const char* name, size_t fieldOffset) {
+    unsigned int total = 0;
+    for (int i = 0; i < recordCount; i++) {
+        total += (unsigned int)strlen((const char*)&records[i] + fieldOffset);
     }
+    writeColumnHeader(file, name, COLUMN_STRING, 4u * (recordCount + 1) + total);
     
-    printf("Enter Product ID to delete: ");
-    fflush(stdout);
-    if (scanf("%d", &deleteID) != 1) {
-        clearInputBuffer();
-        printf("[ERROR] Invalid ID format!\n");
-        return;
+    unsigned int offset = 0;
+    writeUint32(file, offset);
+    for (int i = 0; i < recordCount; i++) {
+        offset += (unsigned int)strlen((const char*)&records[i] + fieldOffset);
+        writeUint32(file, offset);
     }
-    
-    clearInputBuffer();
-    
-    // Find the record
     for (int i = 0; i < recordCount; i++) {
-        if (records[i].id == deleteID) {
-            index = i;
-            found = 1;
-            break;
-        }
+        const char* text = (const char*)&records[i] + fieldOffset;
+        fwrite(text, 1, strlen(text), file);
     }
-    
-    if (!found) {
-        printf("\n[ERROR] Record with ID %d not found!\n", deleteID);
-        return;
+}
+
+// Layout: "APCOL1\0\0", row count, column count, then per column a 16-byte
+// NUL-padded name, type, byte length and the data. Numeric columns are the
+// in-memory id, price and YYYYMMDD date-key arrays (4-byte little-endian)
+int writeColumnarExport(FILE* file) {
+    char magic[8] = {0};
+    strcpy(magic, COLUMNAR_MAGIC);
+    fwrite(magic, 1, sizeof(magic), file);
+    writeUint32(file, (unsigned int)recordCount);
+    writeUint32(file, 5);
+    
+    writeColumnHeader(file, "id", COLUMN_INT32, 4u * recordCount);
+    writeWordColumn(file, idColumn, recordCount);
+    writeStringColumn(file, "product_name", offsetof(Record, productName));
+    writeColumnHeader(file, "price", COLUMN_FLOAT32, 4u * recordCount);
+    writeWordColumn(file, priceColumn, recordCount);
+    writeColumnHeader(file, "date", COLUMN_INT32, 4u * recordCount);
+    writeWordColumn(file, dateKeyColumn, recordCount);
+    writeStringColumn(file, "category", offsetof(Record, category));
+    return recordCount;
+}
+
+// csv, jsonl, columnar or report; 0 if unknown
+int exportFormatFromName(const char* name) {
+    if (strcmp(name, "csv") == 0) return EXPORT_CSV;
+    if (strcmp(name, "jsonl") == 0 || strcmp(name, "json") == 0) return EXPORT_JSONL;
+    if (strcmp(name, "columnar") == 0 || strcmp(name, "col") == 0) return EXPORT_COLUMNAR;
+    if (strcmp(name, "report") == 0) return EXPORT_REPORT;
+    return 0;
+}
+
+// Write every record in a machine-readable format to filename (NULL for a
+// timestamped name); returns the number of records written, or -1 on error
+int exportData(int format, const char* filename) {
+    static const char* extensions[] = {"", "", "csv", "jsonl", "col"};
+    char defaultName[100];
+    
+    if (filename == NULL) {
+        time_t t = time(NULL);
+        struct tm *tm_info = localtime(&t);
+        sprintf(defaultName, "apple_store_export_%04d%02d%02d_%02d%02d%02d.%s",
+                tm_info->tm_year + 1900, tm_info->tm_mon + 1, tm_info->tm_mday,
+                tm_info->tm_hour, tm_info->tm_min, tm_info->tm_sec, extensions[format]);
+        filename = defaultName;
     }
     
-    // Display record to be deleted
-    printf("\n[WARNING] Record to be deleted:\n");
-    printf("+--------------------------------------------------------+\n");
-    printf("| Product ID    : %-40d |\n", records[index].id);
-    printf("| Product Name  : %-40s |\n", records[index].productName);
-    printf("| Price         : $%-38.2f |\n", records[index].price);
-    printf("| Date          : %-40s |\n", records[index].date);
-    printf("| Category      : %-40s |\n", records[index].category);
-    printf("+--------------------------------------------------------+\n");
+    FILE* file = fopen(filename, "wb");
+    if (file == NULL) {
+        printf("[ERROR] Cannot create export file %s!\n", filename);
+        return -1;
+    }
+    setvbuf(file, NULL, _IOFBF, ROW_BUFFER_SIZE);
     
-    // Shift all elements after the deleted one
-    for (int i = index; i < recordCount - 1; i++) {
-        records[i] = records[i + 1];
+    int written;
+    if (format == EXPORT_CSV) {
+        written = writeCsvExport(file);
+    } else if (format == EXPORT_JSONL) {
+        written = writeJsonLinesExport(file);
+    } else {
+        written = writeColumnarExport(file);
     }
     
-    recordCount--;
-    saveToFile();
+    int failed = ferror(file);
+    if (fclose(file) != 0) failed = 1;
+    if (failed) {
+        printf("[ERROR] Could not write export file %s!\n", filename);
+        return -1;
+    }
     
-    printf("\n[OK] Record deleted successfully!\n");
-    printf("   Remaining records: %d\n", recordCount);
+    printf("\n[OK] Exported %d record(s) as %s.\n", written, extensions[format]);
+    printf("   File: %s\n", filename);
+    return written;
 }
 
-// 5. SORT RECORDS - Shows sub-menu for sorting options
-void sortRecords() {
-    int sortChoice;
-    
-    if (recordCount == 0) {
-        printf("\n[ERROR] No records to sort!\n");
-        return;
-    }
+// 7. EXPORT MENU - stock report or machine-readable data
+void exportMenu() {
+    int choice;
     
     while (1) {
-        displaySortMenu();
-        printCenteredNoNL("Enter your choice (1-5): ");
+        printf("\n==============================================================\n");
+        printf("                    EXPORT STOCK DATA                         \n");
+        printf("--------------------------------------------------------------\n");
+        printf("  1. Stock Report (text tables and summaries)                \n");
+        printf("  2. CSV (.csv)                                              \n");
+        printf("  3. JSON Lines (.jsonl)                                     \n");
+        printf("  4. Binary Columnar (.col)                                  \n");
+        printf("  5. Compare Snapshots (added, deleted, modified)            \n");
+        printf("  6. Scheduled Reports (background, every N minutes)         \n");
+        printf("  7. Back to Main Menu                                       \n");
+        printf("==============================================================\n");
+        printCenteredNoNL("Enter your choice (1-7): ");
         fflush(stdout);
         
-        if (scanf("%d", &sortChoice) != 1) {
+        if (scanf("%d", &choice) != 1) {
             clearInputBuffer();
             printf("[ERROR] Invalid input! Please enter a number.\n");
-            printf("Press Enter to continue...");
-            fflush(stdout);
-            getchar();
             continue;
         }
         
         clearInputBuffer();
         
-        switch(sortChoice) {
+        switch(choice) {
             case 1:
-                sortByPriceAscending();
+                exportReport();
                 return;
             case 2:
-                sortByPriceDescending();
+                exportData(EXPORT_CSV, NULL);
                 return;
             case 3:
-                sortByDateAscending();
+                exportData(EXPORT_JSONL, NULL);
                 return;
             case 4:
-                sortByDateDescending();
+                exportData(EXPORT_COLUMNAR, NULL);
                 return;
             case 5:
+                compareSnapshots();
+                return;
+            case 6:
+                scheduledReportsMenu();
+                return;
+            case 7:
                 return;  // Back to main menu
             default:
-                printf("[ERROR] Invalid choice! Please select 1-5.\n");
-                printf("Press Enter to continue...");
-                fflush(stdout);
-                getchar();
+                printf("[ERROR] Invalid choice! Please select 1-7.\n");
         }
     }
 }
 
-// Display sorting sub-menu
-void displaySortMenu() {
-    printf("\n==============================================================\n");
-    printf("                    SORT RECORDS                               \n");
-    printf("--------------------------------------------------------------\n");
-    printf("  1. Sort by Price (Ascending - Lowest to Highest)           \n");
-    printf("  2. Sort by Price (Descending - Highest to Lowest)         \n");
-    printf("  3. Sort by Date (Ascending - Oldest to Newest)            \n");
-    printf("  4. Sort by Date (Descending - Newest to Oldest)           \n");
-    printf("  5. Back to Main Menu                                       \n");
-    printf("==============================================================\n");
-}
+// ============================================================================
+// SNAPSHOT DIFF
+// ============================================================================
 
-// Helper function to compare dates (DD/MM/YYYY format)
-// Returns: -1 if date1 < date2, 0 if equal, 1 if date1 > date2
-int compareDates(char* date1, char* date2) {
-    int day1, month1, year1;
-    int day2, month2, year2;
-    
-    // Parse date1 (DD/MM/YYYY)
-    if (sscanf(date1, "%d/%d/%d", &day1, &month1, &year1) != 3) {
-        return 0;  // Invalid date format
-    }
+// Read a saved data file into out; returns the record count, or -1
+int loadSnapshot(const char* filename, Record* out) {
+    FILE *file = fopen(filename, "r");
+    char line[300];
+    int count = 0;
     
-    // Parse date2 (DD/MM/YYYY)
-    if (sscanf(date2, "%d/%d/%d", &day2, &month2, &year2) != 3) {
-        return 0;  // Invalid date format
+    if (file == NULL) return -1;
+    while (count < MAX_RECORDS && fgets(line, sizeof(line), file) != NULL) {
+        if (parseRecordLine(line, &out[count])) count++;
     }
-    
-    // Compare years
-    if (year1 < year2) return -1;
-    if (year1 > year2) return 1;
-    
-    // Compare months
-    if (month1 < month2) return -1;
-    if (month1 > month2) return 1;
-    
-    // Compare days
-    if (day1 < day2) return -1;
-    if (day1 > day2) return 1;
-    
-    return 0;  // Dates are equal
+    fclose(file);
+    return count;
 }
 
-// Sort by Price (Ascending - Bubble Sort)
-void sortByPriceAscending() {
-    printf("\n==============================================================\n");
-    printf("     SORTING RECORDS BY PRICE (Ascending)                     \n");
-    printf("==============================================================\n\n");
-    
-    // Bubble Sort Algorithm
-    Record temp;
-    int swapped;
-    
-    for (int i = 0; i < recordCount - 1; i++) {
-        swapped = 0;
-        for (int j = 0; j < recordCount - i - 1; j++) {
-            if (records[j].price > records[j + 1].price) {
-                temp = records[j];
-                records[j] = records[j + 1];
-                records[j + 1] = temp;
-                swapped = 1;
-            }
+// Hash join on ID in O(n + m): the earlier snapshot is put in a table, the
+// later one probes it, and earlier records never matched were deleted. A
+// repeated ID matches once; its other copies count as added or deleted
+void diffSnapshots(const Record* before, int beforeCount, const Record* after, int afterCount) {
+    static int table[DIFF_TABLE_SIZE];        // Index + 1 into before[]; 0 = empty
+    static int matchedBefore[MAX_RECORDS];    // Index + 1 into after[]; 0 = deleted
+    static int afterState[MAX_RECORDS];       // 0 = added, 1 = unchanged, 2 = modified
+    static GroupTable categoryDeltas;
+    static GroupAggregate categoryDeltaSlots[GROUP_TABLE_SIZE];
+    GroupAggregate* groups[GROUP_TABLE_SIZE];
+    char key[GROUP_KEY_LENGTH];
+    char label[GROUP_KEY_LENGTH];
+    int added = 0, deleted = 0, modified = 0, repriced = 0;
+    double beforeValue = 0, afterValue = 0, repriceDelta = 0;
+    
+    memset(table, 0, sizeof(table));
+    memset(matchedBefore, 0, sizeof(matchedBefore));
+    groupTableInit(&categoryDeltas, categoryDeltaSlots, GROUP_TABLE_SIZE);
+    
+    for (int i = 0; i < beforeCount; i++) {
+        unsigned int pos = (unsigned int)mixID(before[i].id) & (DIFF_TABLE_SIZE - 1);
+        while (table[pos] != 0 && before[table[pos] - 1].id != before[i].id) {
+            pos = (pos + 1) & (DIFF_TABLE_SIZE - 1);
         }
-        if (!swapped) break;  // Early exit if sorted
+        if (table[pos] == 0) table[pos] = i + 1;
+        beforeValue += before[i].price;
+        groupKeyFor(&before[i], GROUP_BY_CATEGORY, key, label, sizeof(key));
+        GroupAggregate* group = groupFind(&categoryDeltas, key, label, 0);
+        group->count--;
+        group->sum -= before[i].price;
     }
     
-    saveToFile();
-    
-    printf("[OK] Records sorted successfully by Price (Ascending)!\n");
-    printf("   Algorithm: Bubble Sort\n");
-    printf("   Order: Lowest -> Highest (by Price)\n\n");
-    
-    displayAllRecords();
-}
-
-// Sort by Price (Descending - Selection Sort)
-void sortByPriceDescending() {
-    printf("\n==============================================================\n");
-    printf("     SORTING RECORDS BY PRICE (Descending)                    \n");
-    printf("==============================================================\n\n");
-    
-    // Selection Sort Algorithm
-    Record temp;
-    int maxIndex;
-    
-    for (int i = 0; i < recordCount - 1; i++) {
-        maxIndex = i;
-        for (int j = i + 1; j < recordCount; j++) {
-            if (records[j].price > records[maxIndex].price) {
-                maxIndex = j;
-            }
+    for (int j = 0; j < afterCount; j++) {
+        unsigned int pos = (unsigned int)mixID(after[j].id) & (DIFF_TABLE_SIZE - 1);
+        while (table[pos] != 0 && before[table[pos] - 1].id != after[j].id) {
+            pos = (pos + 1) & (DIFF_TABLE_SIZE - 1);
         }
-        if (maxIndex != i) {
-            temp = records[i];
-            records[i] = records[maxIndex];
-            records[maxIndex] = temp;
+        afterState[j] = 0;
+        int i = table[pos] - 1;
+        if (i >= 0 && matchedBefore[i] == 0) {
+            matchedBefore[i] = j + 1;
+            const Record* old = &before[i];
+            if (old->price != after[j].price || strcmp(old->productName, after[j].productName) != 0 ||
+                strcmp(old->date, after[j].date) != 0 || strcmp(old->category, after[j].category) != 0) {
+                afterState[j] = 2;
+                modified++;
+                if (old->price != after[j].price) {
+                    repriced++;
+                    repriceDelta += after[j].price - old->price;
+                }
+            } else {
+                afterState[j] = 1;
+            }
+        } else {
+            added++;
         }
+        afterValue += after[j].price;
+        groupKeyFor(&after[j], GROUP_BY_CATEGORY, key, label, sizeof(key));
+        GroupAggregate* group = groupFind(&categoryDeltas, key, label, 0);
+        group->count++;
+        group->sum += after[j].price;
+    }
+    deleted = beforeCount;
+    for (int i = 0; i < beforeCount; i++) {
+        if (matchedBefore[i] != 0) deleted--;
     }
     
-    saveToFile();
-    
-    printf("[OK] Records sorted successfully by Price (Descending)!\n");
-    printf("   Algorithm: Selection Sort\n");
-    printf("   Order: Highest -> Lowest (by Price)\n\n");
-    
-    displayAllRecords();
-}
-
-// Sort by Date (Ascending - Bubble Sort)
-void sortByDateAscending() {
-    printf("\n==============================================================\n");
-    printf("     SORTING RECORDS BY DATE (Ascending)                      \n");
-    printf("==============================================================\n\n");
-    
-    // Bubble Sort Algorithm
-    Record temp;
-    int swapped;
-    
-    for (int i = 0; i < recordCount - 1; i++) {
-        swapped = 0;
-        for (int j = 0; j < recordCount - i - 1; j++) {
-            if (compareDates(records[j].date, records[j + 1].date) > 0) {
-                temp = records[j];
-                records[j] = records[j + 1];
-                records[j + 1] = temp;
-                swapped = 1;
-            }
+    printf("\nADDED (%d)\n", added);
+    if (added > 0) {
+        printf("+------------+--------------------------------------+------------+------------+------------+\n");
+        printf("| Product ID | Product Name                         | Price      | Date       | Category   |\n");
+        printf("+------------+--------------------------------------+------------+------------+------------+\n");
+        for (int j = 0; j < afterCount; j++) {
+            if (afterState[j] == 0) printRecordRow(&after[j]);
         }
-        if (!swapped) break;  // Early exit if sorted
+        flushRows();
+        printf("+------------+--------------------------------------+------------+------------+------------+\n");
     }
     
-    saveToFile();
-    
-    printf("[OK] Records sorted successfully by Date (Ascending)!\n");
-    printf("   Algorithm: Bubble Sort\n");
-    printf("   Order: Oldest -> Newest (by Date)\n\n");
-    
-    displayAllRecords();
-}
-
-// Sort by Date (Descending - Selection Sort)
-void sortByDateDescending() {
-    printf("\n==============================================================\n");
-    printf("     SORTING RECORDS BY DATE (Descending)                     \n");
-    printf("==============================================================\n\n");
-    
-    // Selection Sort Algorithm
-    Record temp;
-    int maxIndex;
-    
-    for (int i = 0; i < recordCount - 1; i++) {
-        maxIndex = i;
-        for (int j = i + 1; j < recordCount; j++) {
-            if (compareDates(records[j].date, records[maxIndex].date) > 0) {
-                maxIndex = j;
-            }
-        }
-        if (maxIndex != i) {
-            temp = records[i];
-            records[i] = records[maxIndex];
-            records[maxIndex] = temp;
+    printf("\nDELETED (%d)\n", deleted);
+    if (deleted > 0) {
+        printf("+------------+--------------------------------------+------------+------------+------------+\n");
+        printf("| Product ID | Product Name                         | Price      | Date       | Category   |\n");
+        printf("+------------+--------------------------------------+------------+------------+------------+\n");
+        for (int i = 0; i < beforeCount; i++) {
+            if (matchedBefore[i] == 0) printRecordRow(&before[i]);
         }
+        flushRows();
+        printf("+------------+--------------------------------------+------------+------------+------------+\n");
     }
     
-    saveToFile();
-    
-    printf("[OK] Records sorted successfully by Date (Descending)!\n");
-    printf("   Algorithm: Selection Sort\n");
-    printf("   Order: Newest -> Oldest (by Date)\n\n");
-    
-    displayAllRecords();
-}
-
-// 6. UPDATE AN EXISTING RECORD
-void updateRecord() {
-    int updateID;
-    int found = 0;
-    int index = -1;
-    int choice;
-    float newPrice;
-    char newDate[MAX_DATE_LENGTH];
+    printf("\nMODIFIED (%d)\n", modified);
+    if (modified > 0) {
+        printf("+------------+--------------+--------------------------------------+--------------------------------------+\n");
+        printf("| Product ID | Field        | Before                               | After                                |\n");
+        printf("+------------+--------------+--------------------------------------+--------------------------------------+\n");
+        for (int i = 0; i < beforeCount; i++) {
+            if (matchedBefore[i] == 0 || afterState[matchedBefore[i] - 1] != 2) continue;
+            const Record* old = &before[i];
+            const Record* now = &after[matchedBefore[i] - 1];
+            if (strcmp(old->productName, now->productName) != 0) {
+                printf("| %-10d | %-12s | %-36s | %-36s |\n", old->id, "Product Name", old->productName, now->productName);
+            }
+            if (old->price != now->price) {
+                // Snapshot prices are not range-checked, so allow for any float
+                char from[64], to[128];
+                snprintf(from, sizeof(from), "$%.2f", old->price);
+                snprintf(to, sizeof(to), "$%.2f (%+.2f)", now->price, now->price - old->price);
+                printf("| %-10d | %-12s | %-36s | %-36s |\n", old->id, "Price", from, to);
+            }
+            if (strcmp(old->date, now->date) != 0) {
+                printf("| %-10d | %-12s | %-36s | %-36s |\n", old->id, "Date", old->date, now->date);
+            }
+            if (strcmp(old->category, now->category) != 0) {
+                printf("| %-10d | %-12s | %-36s | %-36s |\n", old->id, "Category", old->category, now->category);
+            }
+        }
+        printf("+------------+--------------+--------------------------------------+--------------------------------------+\n");
+    }
+    
+    printf("\nSUMMARY\n");
+    printf("  Records    : %d -> %d (%+d)\n", beforeCount, afterCount, afterCount - beforeCount);
+    printf("  Added      : %d, Deleted: %d, Modified: %d (%d repriced), Unchanged: %d\n",
+           added, deleted, modified, repriced, afterCount - added - modified);
+    printf("  Total Value: $%.2f -> $%.2f (%+.2f)\n", beforeValue, afterValue, afterValue - beforeValue);
+    printf("  Repricing  : %+.2f\n", repriceDelta);
+    
+    int groupCount = sortedGroups(&categoryDeltas, groups);
+    printf("\n%-36s %8s %16s\n", "Category", "Items", "Value Change");
+    for (int g = 0; g < groupCount; g++) {
+        if (groups[g]->count == 0 && groups[g]->sum > -0.005 && groups[g]->sum < 0.005) continue;
+        printf("%-36s %+8d %+16.2f\n", groups[g]->label, groups[g]->count, groups[g]->sum);
+    }
+}
+
+// COMPARE SNAPSHOTS
+// An earlier saved data file against another one, or against the live store
+void compareSnapshots() {
+    char beforeName[200];
+    char afterName[200];
     
     printf("\n==============================================================\n");
-    printf("              UPDATE RECORD                                 \n");
+    printf("              COMPARE SNAPSHOTS                               \n");
     printf("==============================================================\n\n");
     
-    printf("Enter Product ID to update: ");
+    printf("Earlier snapshot file (e.g. a copy of %s): ", FILENAME);
     fflush(stdout);
-    if (scanf("%d", &updateID) != 1) {
-        clearInputBuffer();
-        printf("[ERROR] Invalid ID format!\n");
+    if (fgets(beforeName, sizeof(beforeName), stdin) == NULL) {
+        printf("[ERROR] Failed to read file name!\n");
         return;
     }
+    beforeName[strcspn(beforeName, "\n")] = 0;
     
-    clearInputBuffer();
-    
-    // Find the record
-    for (int i = 0; i < recordCount; i++) {
-        if (records[i].id == updateID) {
-            index = i;
-            found = 1;
-            break;
-        }
+    printf("Later snapshot file (Enter for the live store): ");
+    fflush(stdout);
+    if (fgets(afterName, sizeof(afterName), stdin) == NULL) {
+        printf("[ERROR] Failed to read file name!\n");
+        return;
     }
+    afterName[strcspn(afterName, "\n")] = 0;
     
-    if (!found) {
-        printf("\n[ERROR] Record with ID %d not found!\n", updateID);
+    int beforeCount = loadSnapshot(beforeName, diffBefore);
+    if (beforeCount < 0) {
+        printf("[ERROR] Cannot open snapshot %s!\n", beforeName);
         return;
     }
     
-    // Display current record
-    printf("\nCurrent Record Details:\n");
-    printf("+--------------------------------------------------------+\n");
-    printf("| Product ID    : %-40d |\n", records[index].id);
-    printf("| Product Name  : %-40s |\n", records[index].productName);
-    printf("| Price         : $%-38.2f |\n", records[index].price);
-    printf("| Date          : %-40s |\n", records[index].date);
-    printf("| Category      : %-40s |\n", records[index].category);
-    printf("+--------------------------------------------------------+\n");
+    if (afterName[0] == '\0') {
+        printf("\nComparing %s with the live store\n", beforeName);
+        diffSnapshots(diffBefore, beforeCount, records, recordCount);
+        return;
+    }
     
-    // Get update choice
-    printf("\nWhat would you like to update?\n");
-    printf("  1. Price\n");
-    printf("  2. Date\n");
-    printf("  3. Both (Price and Date)\n");
-    printf("Enter choice (1-3): ");
-    fflush(stdout);
+    int afterCount = loadSnapshot(afterName, diffAfter);
+    if (afterCount < 0) {
+        printf("[ERROR] Cannot open snapshot %s!\n", afterName);
+        return;
+    }
+    printf("\nComparing %s with %s\n", beforeName, afterName);
+    diffSnapshots(diffBefore, beforeCount, diffAfter, afterCount);
+}
+
+// ============================================================================
+// SCHEDULED REPORTS
+// ============================================================================
+
+// Copy the store and its maintained aggregates for the scheduler thread.
+// Called from the menu loop between commands, so records[] is consistent
+void publishSnapshot() {
+    for (int c = 0; c < categoryTotalCount; c++) {
+        if (categoryTotals[c].extremesStale) refreshCategoryExtremes(&categoryTotals[c]);
+        digestCompress(categoryDigest(&categoryTotals[c]));
+    }
     
-    if (scanf("%d", &choice) != 1) {
-        clearInputBuffer();
-        printf("[ERROR] Invalid choice!\n");
+    EnterCriticalSection(&snapshotLock);
+    memcpy(publishedSnapshot.records, records, recordCount * sizeof(Record));
+    publishedSnapshot.recordCount = recordCount;
+    memcpy(publishedSnapshot.totals, categoryTotals, categoryTotalCount * sizeof(CategoryTotal));
+    memcpy(publishedSnapshot.digests, categoryDigests, categoryTotalCount * sizeof(PriceDigest));
+    publishedSnapshot.categoryCount = categoryTotalCount;
+    publishedSnapshot.generation = dataGeneration;
+    publishedSnapshot.takenAt = time(NULL);
+    LeaveCriticalSection(&snapshotLock);
+}
+
+void publishSnapshotIfChanged() {
+    // Only this thread writes publishedSnapshot, so reading it unlocked is safe
+    if (schedulerThread != NULL && publishedSnapshot.generation != dataGeneration) {
+        publishSnapshot();
+    }
+}
+
+void setScheduleStatus(const char* status) {
+    EnterCriticalSection(&snapshotLock);
+    strncpy(scheduleStatus, status, SCHEDULE_STATUS_LENGTH - 1);
+    scheduleStatus[SCHEDULE_STATUS_LENGTH - 1] = '\0';
+    LeaveCriticalSection(&snapshotLock);
+}
+
+// Same tables as exportReport, from the snapshot only; rows are formatted
+// into a chunk buffer and grouped into tables of this thread's own
+void writeScheduledReportFile(FILE* file, StoreSnapshot* snapshot) {
+    static const int groupings[] = {GROUP_BY_PRODUCT, GROUP_BY_MONTH, GROUP_BY_PRICE_BAND};
+    static char chunk[ROW_BUFFER_SIZE];
+    static GroupTable groups[GROUP_BY_COUNT];
+    static GroupAggregate groupSlots[GROUP_BY_COUNT][GROUP_TABLE_SIZE];
+    size_t length = 0;
+    time_t now = time(NULL);
+    double totalValue = 0;
+    
+    fprintf(file, "==============================================================\n");
+    fprintf(file, "            MY APPLE-STORE SYSTEM                             \n");
+    fprintf(file, "              SCHEDULED STOCK REPORT                          \n");
+    fprintf(file, "==============================================================\n\n");
+    fprintf(file, "Generated on: %s", asctime(localtime(&now)));
+    fprintf(file, "Snapshot of : %s", asctime(localtime(&snapshot->takenAt)));
+    fprintf(file, "Total Records: %d\n\n", snapshot->recordCount);
+    
+    if (snapshot->recordCount == 0) {
+        fprintf(file, "No records in stock.\n");
         return;
     }
     
-    clearInputBuffer();
+    fprintf(file, "+------------+--------------------------------------+------------+------------+------------+\n");
+    fprintf(file, "| Product ID | Product Name                         | Price      | Date       | Category   |\n");
+    fprintf(file, "+------------+--------------------------------------+------------+------------+------------+\n");
+    for (int i = 0; i < snapshot->recordCount; i++) {
+        if (sizeof(chunk) - length < TABLE_ROW_LENGTH) {
+            fwrite(chunk, 1, length, file);
+            length = 0;
+        }
+        length += formatRecordRow(chunk + length, &snapshot->records[i]);
+    }
+    fwrite(chunk, 1, length, file);
+    fprintf(file, "+------------+--------------------------------------+------------+------------+------------+\n");
     
-    // Process update
-    switch(choice) {
-        case 1:
-            printf("Enter new Price ($): ");
-            fflush(stdout);
-            if (scanf("%f", &newPrice) != 1) {
-                clearInputBuffer();
-                printf("[ERROR] Invalid price format!\n");
-                return;
-            }
-            if (!validatePrice(newPrice)) {
-                return;
-            }
-            records[index].price = newPrice;
-            break;
-            
-        case 2:
-            printf("Enter new Date (DD/MM/YYYY): ");
-            fflush(stdout);
-            if (fgets(newDate, MAX_DATE_LENGTH, stdin) == NULL) {
-                printf("[ERROR] Failed to read date!\n");
-                return;
-            }
-            newDate[strcspn(newDate, "\n")] = 0;
-            if (!validateDate(newDate)) {
-                return;
-            }
-            strcpy(records[index].date, newDate);
-            break;
-            
-        case 3:
-            printf("Enter new Price ($): ");
-            fflush(stdout);
-            if (scanf("%f", &newPrice) != 1) {
-                clearInputBuffer();
-                printf("[ERROR] Invalid price format!\n");
-                return;
-            }
-            if (!validatePrice(newPrice)) {
-                return;
-            }
-            records[index].price = newPrice;
-            
-                clearInputBuffer();
-            printf("Enter new Date (DD/MM/YYYY): ");
-            fflush(stdout);
-            if (fgets(newDate, MAX_DATE_LENGTH, stdin) == NULL) {
-                printf("[ERROR] Failed to read date!\n");
-                return;
-            }
-            newDate[strcspn(newDate, "\n")] = 0;
-            if (!validateDate(newDate)) {
-                return;
-            }
-            strcpy(records[index].date, newDate);
-            break;
-            
-        default:
-            printf("[ERROR] Invalid choice!\n");
-            return;
+    for (int k = 0; k < 3; k++) {
+        groupTableInit(&groups[groupings[k]], groupSlots[groupings[k]], GROUP_TABLE_SIZE);
     }
+    groupByRange(groups, groupings, 3, snapshot->records, 0, snapshot->recordCount);
     
-    clearInputBuffer();
-    saveToFile();
+    writeCategorySummary(file, snapshot->totals, snapshot->categoryCount);
+    writeDigestSummary(file, snapshot->totals, snapshot->digests, snapshot->categoryCount, snapshot->recordCount);
+    writeGroupSummary(file, "PRODUCT", &groups[GROUP_BY_PRODUCT]);
+    writeGroupSummary(file, "MONTH", &groups[GROUP_BY_MONTH]);
+    writeGroupSummary(file, "PRICE BAND", &groups[GROUP_BY_PRICE_BAND]);
     
-    printf("\n[OK] Record updated successfully!\n");
-    printf("+--------------------------------------------------------+\n");
-    printf("| Product ID    : %-40d |\n", records[index].id);
-    printf("| Product Name  : %-40s |\n", records[index].productName);
-    printf("| Price         : $%-38.2f |\n", records[index].price);
-    printf("| Date          : %-40s |\n", records[index].date);
-    printf("| Category      : %-40s |\n", records[index].category);
-    printf("+--------------------------------------------------------+\n");
+    for (int c = 0; c < snapshot->categoryCount; c++) {
+        totalValue += snapshot->totals[c].value;
+    }
+    fprintf(file, "--------------------------------------------------------------\n");
+    fprintf(file, "TOTAL    : %d items, Total Value: $%.2f\n", snapshot->recordCount, totalValue);
 }
 
-// 7. EXPORT STOCK REPORT
-void exportReport() {
-    FILE *reportFile;
-    char filename[100];
-    time_t t = time(NULL);
-    struct tm *tm_info = localtime(&t);
+int fileExists(const char* path) {
+    FILE* file = fopen(path, "rb");
+    if (file == NULL) return 0;
+    fclose(file);
+    return 1;
+}
+
+// Gzip the current report into archive 1, shifting older archives up only
+// as far as the first free slot (dropping the oldest when all are taken).
+// The archives are not touched until the compressed copy exists, so a
+// failure loses nothing; the current report itself is left for the caller
+// to replace. Returns 0 if it could not be archived
+int rotateScheduledReports() {
+    char from[64], to[64];
+    int slot = 1;
+    
+    if (!fileExists(SCHEDULE_REPORT)) return 1;   // First report: nothing to archive
+    if (!gzipFile(SCHEDULE_REPORT, SCHEDULE_ARCHIVE_TEMP)) return 0;
+    
+    for (; slot < SCHEDULE_KEEP_ARCHIVES; slot++) {
+        sprintf(to, SCHEDULE_ARCHIVE, slot);
+        if (!fileExists(to)) break;
+    }
+    sprintf(to, SCHEDULE_ARCHIVE, slot);
+    remove(to);
+    for (int k = slot - 1; k >= 1; k--) {
+        sprintf(from, SCHEDULE_ARCHIVE, k);
+        sprintf(to, SCHEDULE_ARCHIVE, k + 1);
+        rename(from, to);
+    }
+    sprintf(to, SCHEDULE_ARCHIVE, 1);
+    if (rename(SCHEDULE_ARCHIVE_TEMP, to) != 0) {
+        remove(SCHEDULE_ARCHIVE_TEMP);
+        return 0;
+    }
+    return 1;
+}
+
+// Returns 1 if the report was written
+int writeScheduledReport(StoreSnapshot* snapshot) {
+    FILE* file = fopen(SCHEDULE_TEMP, "w");
+    if (file == NULL) {
+        setScheduleStatus("[ERROR] Cannot create " SCHEDULE_TEMP);
+        return 0;
+    }
+    setvbuf(file, NULL, _IOFBF, ROW_BUFFER_SIZE);
+    writeScheduledReportFile(file, snapshot);
+    int failed = ferror(file);
+    if (fclose(file) != 0 || failed) {
+        remove(SCHEDULE_TEMP);
+        setScheduleStatus("[ERROR] Could not write the scheduled report");
+        return 0;
+    }
     
-    // Generate filename with timestamp
-    sprintf(filename, "apple_store_report_%04d%02d%02d_%02d%02d%02d.txt",
-            tm_info->tm_year + 1900, tm_info->tm_mon + 1, tm_info->tm_mday,
-            tm_info->tm_hour, tm_info->tm_min, tm_info->tm_sec);
+    if (!rotateScheduledReports()) {
+        setScheduleStatus("[ERROR] Cannot compress the previous report; new one left in " SCHEDULE_TEMP);
+        return 0;
+    }
+    // The previous report is archived by now, so it can make way for the new one
+    remove(SCHEDULE_REPORT);
+    if (rename(SCHEDULE_TEMP, SCHEDULE_REPORT) != 0) {
+        setScheduleStatus("[ERROR] Cannot rename " SCHEDULE_TEMP "; previous report is in archive 1");
+        return 0;
+    }
+    return 1;
+}
+
+// Report now, then every scheduleMinutes; a snapshot that has not changed
+// since the last report is not written again
+DWORD WINAPI schedulerMain(LPVOID arg) {
+    (void)arg;
+    while (!schedulerStop) {
+        int changed = 0;
+        EnterCriticalSection(&snapshotLock);
+        if (publishedSnapshot.generation != reportedGeneration) {
+            memcpy(&reportSnapshot, &publishedSnapshot, sizeof(StoreSnapshot));
+            changed = 1;
+        }
+        LeaveCriticalSection(&snapshotLock);
+        
+        if (changed && writeScheduledReport(&reportSnapshot)) {
+            reportedGeneration = reportSnapshot.generation;
+            EnterCriticalSection(&snapshotLock);
+            scheduledReportCount++;
+            lastScheduledReport = time(NULL);
+            sprintf(scheduleStatus, "[OK] Report written (%d records)", reportSnapshot.recordCount);
+            LeaveCriticalSection(&snapshotLock);
+        } else if (!changed) {
+            setScheduleStatus("[OK] No changes since the last report");
+        }
+        
+        // Sleep in short steps so a stop request is noticed quickly
+        for (long step = 0; step < scheduleMinutes * 60L * 5 && !schedulerStop; step++) {
+            Sleep(200);
+        }
+    }
+    return 0;
+}
+
+// Returns 1 if the scheduler thread is running
+int startScheduler(int minutes) {
+    if (!snapshotLockReady) {
+        InitializeCriticalSection(&snapshotLock);
+        snapshotLockReady = 1;
+    }
+    stopScheduler();
     
-    reportFile = fopen(filename, "w");
+    scheduleMinutes = minutes;
+    schedulerStop = 0;
+    publishSnapshot();
+    schedulerThread = CreateThread(NULL, 0, schedulerMain, NULL, 0, NULL);
+    return schedulerThread != NULL;
+}
+
+void stopScheduler() {
+    if (schedulerThread == NULL) return;
+    schedulerStop = 1;
+    WaitForSingleObject(schedulerThread, INFINITE);
+    CloseHandle(schedulerThread);
+    schedulerThread = NULL;
+}
+
+// SCHEDULED REPORTS MENU
+void scheduledReportsMenu() {
+    char input[20];
+    char status[SCHEDULE_STATUS_LENGTH];
+    int count = 0;
+    time_t last = 0;
+    int choice;
     
-    if (reportFile == NULL) {
-        printf("[ERROR] Cannot create report file!\n");
-        return;
+    if (snapshotLockReady) {
+        EnterCriticalSection(&snapshotLock);
+        strcpy(status, scheduleStatus);
+        count = scheduledReportCount;
+        last = lastScheduledReport;
+        LeaveCriticalSection(&snapshotLock);
+    } else {
+        strcpy(status, scheduleStatus);
     }
     
-    // Write report header
-    fprintf(reportFile, "==============================================================\n");
-    fprintf(reportFile, "            MY APPLE-STORE SYSTEM                             \n");
-    fprintf(reportFile, "              STOCK REPORT                                    \n");
-    fprintf(reportFile, "==============================================================\n\n");
-    fprintf(reportFile, "Generated on: %s", asctime(tm_info));
-    fprintf(reportFile, "Total Records: %d\n\n", recordCount);
-    
-    if (recordCount == 0) {
-        fprintf(reportFile, "No records in stock.\n");
+    printf("\n==============================================================\n");
+    printf("              SCHEDULED REPORTS                               \n");
+    printf("==============================================================\n");
+    if (schedulerThread != NULL) {
+        printf("Scheduler   : Running, every %d minute(s)\n", scheduleMinutes);
     } else {
-        // Write table header
-        fprintf(reportFile, "+------------+--------------------------------------+------------+------------+------------+\n");
-        fprintf(reportFile, "| Product ID | Product Name                         | Price      | Date       | Category   |\n");
-        fprintf(reportFile, "+------------+--------------------------------------+------------+------------+------------+\n");
-        
-        // Write all records
-        for (int i = 0; i < recordCount; i++) {
-            fprintf(reportFile, "| %-10d | %-36s | $%-9.2f | %-10s | %-10s |\n", 
-                   records[i].id, records[i].productName, 
-                   records[i].price, records[i].date, records[i].category);
+        printf("Scheduler   : Stopped\n");
+    }
+    printf("Reports     : %d written this session", count);
+    if (count > 0) printf(", last at %s", asctime(localtime(&last)));
+    else printf("\n");
+    printf("Last result : %s\n", status);
+    printf("Files       : %s (latest), older ones gzipped as\n", SCHEDULE_REPORT);
+    printf("              apple_store_scheduled.1.txt.gz ... .%d.txt.gz\n", SCHEDULE_KEEP_ARCHIVES);
+    printf("--------------------------------------------------------------\n");
+    printf("  1. Start (or change the interval)                          \n");
+    printf("  2. Stop                                                    \n");
+    printf("  3. Back                                                    \n");
+    printf("==============================================================\n");
+    printCenteredNoNL("Enter your choice (1-3): ");
+    fflush(stdout);
+    if (scanf("%d", &choice) != 1) {
+        clearInputBuffer();
+        printf("[ERROR] Invalid input! Please enter a number.\n");
+        return;
+    }
+    clearInputBuffer();
+    
+    if (choice == 1) {
+        int minutes = SCHEDULE_DEFAULT_MINUTES;
+        printf("Interval in minutes (Enter for %d): ", SCHEDULE_DEFAULT_MINUTES);
+        fflush(stdout);
+        if (fgets(input, sizeof(input), stdin) != NULL && input[0] != '\n') {
+            if (sscanf(input, "%d", &minutes) != 1 || minutes < 1 || minutes > 1440) {
+                printf("[ERROR] Interval must be between 1 and 1440 minutes!\n");
+                return;
+            }
         }
+        if (startScheduler(minutes)) {
+            printf("\n[OK] Scheduled reports every %d minute(s); the first is being written now.\n", minutes);
+        } else {
+            printf("[ERROR] Cannot start the scheduler thread!\n");
+        }
+    } else if (choice == 2) {
+        if (schedulerThread == NULL) {
+            printf("\n[OK] The scheduler is not running.\n");
+        } else {
+            stopScheduler();
+            printf("\n[OK] Scheduled reports stopped.\n");
+        }
+    } else if (choice != 3) {
+        printf("[ERROR] Invalid choice! Please select 1-3.\n");
+    }
+}
+
+// ============================================================================
+// GZIP COMPRESSION
+// ============================================================================
+unsigned long crc32Update(unsigned long crc, const unsigned char* data, size_t length) {
+    crc = ~crc & 0xFFFFFFFFUL;
+    for (size_t i = 0; i < length; i++) {
+        crc ^= data[i];
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc >> 1) ^ (0xEDB88320UL & (0UL - (crc & 1)));
+        }
+    }
+    return ~crc & 0xFFFFFFFFUL;
+}
+
+void bitWrite(BitWriter* writer, unsigned int value, int count) {
+    writer->bits |= (unsigned long)value << writer->count;
+    writer->count += count;
+    while (writer->count >= 8) {
+        fputc((int)(writer->bits & 0xFF), writer->file);
+        writer->bits >>= 8;
+        writer->count -= 8;
+    }
+}
+
+// Huffman codes are sent most significant bit first
+void bitWriteCode(BitWriter* writer, unsigned int code, int length) {
+    unsigned int reversed = 0;
+    for (int i = 0; i < length; i++) {
+        reversed = (reversed << 1) | ((code >> i) & 1);
+    }
+    bitWrite(writer, reversed, length);
+}
+
+// Fixed literal/length code (RFC 1951, 3.2.6)
+void deflateLiteral(BitWriter* writer, int symbol) {
+    if (symbol < 144) bitWriteCode(writer, 0x30 + symbol, 8);
+    else if (symbol < 256) bitWriteCode(writer, 0x190 + symbol - 144, 9);
+    else if (symbol < 280) bitWriteCode(writer, symbol - 256, 7);
+    else bitWriteCode(writer, 0xC0 + symbol - 280, 8);
+}
+
+void deflateMatch(BitWriter* writer, int length, int distance) {
+    static const int lengthBase[29] = {3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+                                       35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+    static const int lengthExtra[29] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+                                        3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+    static const int distanceBase[30] = {1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+                                         257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145,
+                                         8193, 12289, 16385, 24577};
+    static const int distanceExtra[30] = {0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+                                          7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+    int code = 28;
+    while (lengthBase[code] > length) code--;
+    deflateLiteral(writer, 257 + code);
+    bitWrite(writer, length - lengthBase[code], lengthExtra[code]);
+    
+    code = 29;
+    while (distanceBase[code] > distance) code--;
+    bitWriteCode(writer, code, 5);
+    bitWrite(writer, distance - distanceBase[code], distanceExtra[code]);
+}
+
+// Write source as a .gz file readable by gzip, 7-Zip and the like;
+// returns 1 on success (target is removed on failure)
+int gzipFile(const char* source, const char* target) {
+    static const unsigned char header[10] = {0x1F, 0x8B, 8, 0, 0, 0, 0, 0, 0, 255};
+    FILE* in = fopen(source, "rb");
+    if (in == NULL) return 0;
+    
+    fseek(in, 0, SEEK_END);
+    long size = ftell(in);
+    fseek(in, 0, SEEK_SET);
+    unsigned char* data = malloc(size > 0 ? (size_t)size : 1);
+    int* head = malloc(sizeof(int) << GZIP_HASH_BITS);
+    int* previous = malloc((size > 0 ? (size_t)size : 1) * sizeof(int));
+    FILE* out = NULL;
+    int ok = data != NULL && head != NULL && previous != NULL && size >= 0 &&
+             fread(data, 1, (size_t)size, in) == (size_t)size;
+    fclose(in);
+    if (ok) out = fopen(target, "wb");
+    
+    if (out != NULL) {
+        BitWriter writer = {out, 0, 0};
+        fwrite(header, 1, sizeof(header), out);
+        bitWrite(&writer, 1, 1);     // Final block
+        bitWrite(&writer, 1, 2);     // Fixed Huffman codes
         
-        fprintf(reportFile, "+------------+--------------------------------------+------------+------------+------------+\n");
-        
-        // Calculate totals by category
-        float totalValue = 0;
-        int iphoneCount = 0, macbookCount = 0, iwatchCount = 0;
-        float iphoneValue = 0, macbookValue = 0, iwatchValue = 0;
-        
-        for (int i = 0; i < recordCount; i++) {
-            totalValue += records[i].price;
-            if (strcmp(records[i].category, "iPhones") == 0) {
-                iphoneCount++;
-                iphoneValue += records[i].price;
-            } else if (strcmp(records[i].category, "MacBooks") == 0) {
-                macbookCount++;
-                macbookValue += records[i].price;
-            } else if (strcmp(records[i].category, "iWatch") == 0) {
-                iwatchCount++;
-                iwatchValue += records[i].price;
+        for (int h = 0; h < (1 << GZIP_HASH_BITS); h++) head[h] = -1;
+        long pos = 0;
+        while (pos < size) {
+            int bestLength = 0;
+            int bestDistance = 0;
+            
+            if (pos + GZIP_MIN_MATCH <= size) {
+                unsigned int hash = ((unsigned int)data[pos] << 16 | (unsigned int)data[pos + 1] << 8 | data[pos + 2])
+                                    * 2654435761u >> (32 - GZIP_HASH_BITS);
+                int maxLength = size - pos < GZIP_MAX_MATCH ? (int)(size - pos) : GZIP_MAX_MATCH;
+                int chain = GZIP_MAX_CHAIN;
+                for (int candidate = head[hash]; candidate >= 0 && pos - candidate <= GZIP_WINDOW && chain-- > 0;
+                     candidate = previous[candidate]) {
+                    int length = 0;
+                    while (length < maxLength && data[candidate + length] == data[pos + length]) length++;
+                    if (length > bestLength) {
+                        bestLength = length;
+                        bestDistance = (int)(pos - candidate);
+                        if (length == maxLength) break;
+                    }
+                }
+            }
+            
+            int advance = bestLength >= GZIP_MIN_MATCH ? bestLength : 1;
+            if (advance > 1) deflateMatch(&writer, bestLength, bestDistance);
+            else deflateLiteral(&writer, data[pos]);
+            
+            // Every position passed over joins the hash chains
+            for (long end = pos + advance; pos < end; pos++) {
+                if (pos + GZIP_MIN_MATCH > size) continue;
+                unsigned int hash = ((unsigned int)data[pos] << 16 | (unsigned int)data[pos + 1] << 8 | data[pos + 2])
+                                    * 2654435761u >> (32 - GZIP_HASH_BITS);
+                previous[pos] = head[hash];
+                head[hash] = (int)pos;
             }
         }
+        deflateLiteral(&writer, 256);     // End of block
+        if (writer.count > 0) fputc((int)(writer.bits & 0xFF), out);
         
-        fprintf(reportFile, "\n--------------------------------------------------------------\n");
-        fprintf(reportFile, "                    SUMMARY BY CATEGORY                       \n");
-        fprintf(reportFile, "--------------------------------------------------------------\n");
-        fprintf(reportFile, "iPhones  : %d items, Total Value: $%.2f\n", iphoneCount, iphoneValue);
-        fprintf(reportFile, "MacBooks : %d items, Total Value: $%.2f\n", macbookCount, macbookValue);
-        fprintf(reportFile, "iWatch    : %d items, Total Value: $%.2f\n", iwatchCount, iwatchValue);
-        fprintf(reportFile, "--------------------------------------------------------------\n");
-        fprintf(reportFile, "TOTAL    : %d items, Total Value: $%.2f\n", recordCount, totalValue);
+        writeUint32(out, (unsigned int)crc32Update(0, data, (size_t)size));
+        writeUint32(out, (unsigned int)size);
+        ok = !ferror(out);
+        if (fclose(out) != 0) ok = 0;
+        if (!ok) remove(target);
+    } else {
+        ok = 0;
     }
     
-    fclose(reportFile);
-    
-    printf("\n[OK] Stock report exported successfully!\n");
-    printf("   File: %s\n", filename);
+    free(data);
+    free(head);
+    free(previous);
+    return ok;
 }
 
@@ -14,6 +14,13 @@
 #define FILENAME "question2_data.txt"
 #define MIN_RECORDS 10
 
+// External merge sort (data files larger than MAX_RECORDS)
+#define EXTERNAL_SORT_DEFAULT_KB 64
+#define EXTERNAL_SORT_MAX_FANIN 16
+#define EXTERNAL_SORT_IO_BUFFER (64 * 1024)   // Largest file buffer
+#define EXTERNAL_SORT_MIN_IO_BUFFER 1024
+#define SORTED_DATA_FILENAME "question2_data_sorted.txt"
+
 // Custom categories support
 #define MAX_CUSTOM_CATEGORIES 20
 #define MAX_PRODUCTS_PER_CUSTOM 20
@@ -36,10 +43,67 @@ typedef struct {
 // Global variables
 Record records[MAX_RECORDS];
 int recordCount = 0;
-// Track last sort performed: field (1=Price,2=ID), algorithm (1=Bubble,2=Selection), order (1=Ascending,0=Descending)
+// Offset in the data file of the first line past MAX_RECORDS records, or -1 if
+// the whole file was loaded; saveToFile copies that tail back unchanged
+long unloadedTailOffset = -1;
+// Track last sort performed: field (1=Price,2=ID), algorithm (1=Bubble,2=Selection,3=External), order (1=Ascending,0=Descending)
 int lastSortField = 0;
 int lastSortAlgorithm = 0;
 int lastSortOrder = 1; // default ascending
+// Key and direction used by the external merge sort
+int externalSortField = 1;      // 1=Price, 2=ID
+int externalSortAscending = 1;
+size_t externalSortBudget = EXTERNAL_SORT_DEFAULT_KB * 1024;   // Last budget used, for Re-Sort
+
+// Sorted views: permutation arrays over records[] kept in key order as the
+// store changes, so several orderings are available without moving records
+#define VIEW_STORED -1
+#define VIEW_PRICE 0
+#define VIEW_DATE 1
+#define VIEW_COUNT 2
+
+typedef struct {
+    const char* name;
+    int (*compare)(const Record* a, const Record* b);
+    int order[MAX_RECORDS];   // Slots into records[], ascending by compare
+    int count;
+} SortedView;
+
+// Group-by engine: hash table (open addressing) of aggregates per group key
+#define GROUP_BY_CATEGORY 0
+#define GROUP_BY_PRODUCT 1
+#define GROUP_BY_MONTH 2
+#define GROUP_BY_PRICE_BAND 3
+#define GROUP_BY_COUNT 4
+#define GROUP_TABLE_SIZE 1024     // Power of two, over twice MAX_RECORDS
+#define GROUP_KEY_LENGTH 80
+#define REPORT_PRICE_BAND 500
+
+typedef struct {
+    char key[GROUP_KEY_LENGTH];     // Match key (names case-folded)
+    char label[GROUP_KEY_LENGTH];   // Display text of the first record seen
+    int used;                       // Slot holds a group (any key, even empty)
+    long rank;                      // Numeric order (month, band); 0 = by key
+    int count;
+    double sum;
+    float min;
+    float max;
+} GroupAggregate;
+
+typedef struct {
+    GroupAggregate slots[GROUP_TABLE_SIZE];
+    int groupCount;
+} GroupTable;
+
+GroupTable reportGroups[GROUP_BY_COUNT];
+
+// Table rows are formatted by hand into one reusable buffer and written out
+// in large chunks, since stdout is unbuffered and printf parses its format
+// for every row
+#define ROW_BUFFER_SIZE (64 * 1024)
+#define TABLE_ROW_LENGTH 192       // Longest possible row, with margin
+char rowBuffer[ROW_BUFFER_SIZE];
+size_t rowBufferLength = 0;
 
 // Apple Product Lists (5 categories, 2 products each - no inches)
 const char* iphones[] = {
@@ -92,6 +156,23 @@ void resortLastSort();
 void exportReport();
 void loadFromFile();
 void saveToFile();
+void saveWithUnloadedTail();
+int parseRecordLine(char* line, Record* out);
+void writeRecordLine(FILE* file, const Record* r);
+void externalSortMenu();
+int compareForExternalSort(const Record* a, const Record* b);
+int qsortExternalCompare(const void* a, const void* b);
+void runFileName(char* buffer, size_t size, int pass, int index);
+int readRecordLine(FILE* file, Record* out);
+void writeReportRow(FILE* file, const Record* r);
+size_t externalSortBufferSize(size_t budgetBytes);
+void removeRuns(int pass, int first, int count);
+int createSortedRuns(const char* source, size_t runCapacity, size_t ioBuffer);
+int mergeHeapLess(Record* heads, int a, int b);
+void mergeHeapSiftDown(int* heap, int size, Record* heads, int pos);
+long mergeRuns(int pass, int first, int count, FILE* out, int asReport, size_t ioBuffer);
+int externalSortFile(const char* source, FILE* out, size_t budgetBytes, int asReport);
+int externalSortDataFile(size_t budgetBytes);
 void clearScreen();
 void displayCategoryMenu();
 int getCategoryChoice();
@@ -99,6 +180,35 @@ void displayProductSubmenu(int category);
 int getProductChoice(int category);
 void createCategoryInteractive();
 int generateNextID(int categoryChoice);
+void displayRecordsMenu();
+void displayRecordsInView(int viewId, int descending);
+int dateToKey(const char* date);
+int compareByPrice(const Record* a, const Record* b);
+int compareByDate(const Record* a, const Record* b);
+void viewInsertSlot(SortedView* view, int slot);
+void rebuildViews();
+void indexInsertRecord(int slot);
+void rebuildIndexes();
+size_t appendPaddedText(char* out, const char* text, int width);
+size_t appendPaddedInt(char* out, long value, int width);
+size_t appendPaddedMoney(char* out, float value, int width);
+size_t formatRecordRow(char* out, const Record* r);
+char* reserveRow();
+void printRecordRow(const Record* r);
+void flushRows();
+unsigned int groupHash(const char* key);
+void toLowerCase(const char* src, char* dest, size_t size);
+long groupKeyFor(const Record* r, int groupBy, char* key, char* label, size_t size);
+GroupAggregate* groupFind(GroupTable* table, const char* key, const char* label, long rank);
+void groupByRecords(GroupTable* tables, int tableCount);
+int compareGroups(const void* a, const void* b);
+int sortedGroups(GroupTable* table, GroupAggregate** out);
+void writeGroupSummary(FILE* file, const char* title, GroupTable* table);
+
+SortedView views[VIEW_COUNT] = {
+    {.name = "Price", .compare = compareByPrice},
+    {.name = "Date", .compare = compareByDate}
+};
 
 // ============================================================================
 // MAIN FUNCTION
@@ -154,7 +264,7 @@ int main() {
                 insertRecord();
                 break;
             case 2:
-                displayAllRecords();
+                displayRecordsMenu();
                 break;
             case 3:
                 searchByID();
@@ -588,6 +698,56 @@ void createCategoryInteractive() {
 // ============================================================================
 // FILE OPERATIONS
 // ============================================================================
+// Parse one line: ID|ProductName|Price|Date|Category
+// Returns 1 on success, 0 if the line is malformed (line is modified in place)
+int parseRecordLine(char* line, Record* out) {
+    char *p = line;
+    char *end;
+    
+    // Get ID
+    out->id = (int)strtol(p, &end, 10);
+    if (end == p || *end != '|') return 0;
+    p = end + 1;
+    
+    // Get Product Name
+    end = strchr(p, '|');
+    if (end == NULL) return 0;
+    *end = '\0';
+    strncpy(out->productName, p, MAX_NAME_LENGTH - 1);
+    out->productName[MAX_NAME_LENGTH - 1] = '\0';
+    p = end + 1;
+    
+    // Get Price
+    out->price = (float)strtod(p, &end);
+    if (end == p || *end != '|') return 0;
+    p = end + 1;
+    
+    // Get Date
+    end = strchr(p, '|');
+    if (end == NULL) return 0;
+    *end = '\0';
+    strncpy(out->date, p, MAX_DATE_LENGTH - 1);
+    out->date[MAX_DATE_LENGTH - 1] = '\0';
+    p = end + 1;
+    
+    // Get Category (rest of line, remove newline)
+    end = strpbrk(p, "\r\n");
+    if (end != NULL) *end = '\0';
+    strncpy(out->category, p, 19);
+    out->category[19] = '\0';
+    
+    return 1;
+}
+
+void writeRecordLine(FILE* file, const Record* r) {
+    fprintf(file, "%d|%s|%.2f|%s|%s\n", 
+            r->id,
+            r->productName,
+            r->price,
+            r->date,
+            r->category);
+}
+
 void loadFromFile() {
     FILE *file = fopen(FILENAME, "r");
     
@@ -597,52 +757,34 @@ void loadFromFile() {
     }
     
     recordCount = 0;
+    unloadedTailOffset = -1;
     char line[300];
     while (recordCount < MAX_RECORDS && fgets(line, sizeof(line), file) != NULL) {
-        // Parse: ID|ProductName|ItemNumber|Price|Date|Category
-        char *p = line;
-        char *end;
-        
-        // Get ID
-        records[recordCount].id = (int)strtol(p, &end, 10);
-        if (end == p || *end != '|') continue;
-        p = end + 1;
-        
-        // Get Product Name
-        end = strchr(p, '|');
-        if (end == NULL) continue;
-        *end = '\0';
-        strncpy(records[recordCount].productName, p, MAX_NAME_LENGTH - 1);
-        records[recordCount].productName[MAX_NAME_LENGTH - 1] = '\0';
-        p = end + 1;
-        
-        // Get Price
-        records[recordCount].price = (float)strtod(p, &end);
-        if (end == p || *end != '|') continue;
-        p = end + 1;
-        
-        // Get Date
-        end = strchr(p, '|');
-        if (end == NULL) continue;
-        *end = '\0';
-        strncpy(records[recordCount].date, p, MAX_DATE_LENGTH - 1);
-        records[recordCount].date[MAX_DATE_LENGTH - 1] = '\0';
-        p = end + 1;
-        
-        // Get Category (rest of line, remove newline)
-        end = strchr(p, '\n');
-        if (end != NULL) *end = '\0';
-        strncpy(records[recordCount].category, p, 19);
-        records[recordCount].category[19] = '\0';
-        
-        recordCount++;
+        if (parseRecordLine(line, &records[recordCount])) {
+            recordCount++;
+        }
+    }
+    if (recordCount == MAX_RECORDS) {
+        long offset = ftell(file);
+        Record extra;
+        if (readRecordLine(file, &extra)) {
+            unloadedTailOffset = offset;
+            printf("[WARNING] %s holds more than %d records; only the first %d are loaded.\n",
+                   FILENAME, MAX_RECORDS, MAX_RECORDS);
+        }
     }
     
     fclose(file);
   // Assume unsorted after loading
+    rebuildIndexes();
 }
 
 void saveToFile() {
+    if (unloadedTailOffset >= 0) {
+        saveWithUnloadedTail();
+        return;
+    }
+    
     FILE *file = fopen(FILENAME, "w");
     
     if (file == NULL) {
@@ -651,17 +793,51 @@ void saveToFile() {
     }
     
     for (int i = 0; i < recordCount; i++) {
-        fprintf(file, "%d|%s|%.2f|%s|%s\n", 
-                records[i].id,
-                records[i].productName,
-                records[i].price,
-                records[i].date,
-                records[i].category);
+        writeRecordLine(file, &records[i]);
     }
     
     fclose(file);
 }
 
+// Save records[] followed by the records that did not fit at load time
+void saveWithUnloadedTail() {
+    const char* tempName = "question2_data_save.tmp";
+    FILE* old = fopen(FILENAME, "r");
+    FILE* file = fopen(tempName, "w");
+    
+    if (old == NULL || file == NULL || fseek(old, unloadedTailOffset, SEEK_SET) != 0) {
+        if (old != NULL) fclose(old);
+        if (file != NULL) fclose(file);
+        remove(tempName);
+        printf("[ERROR] Cannot save to file!\n");
+        return;
+    }
+    
+    for (int i = 0; i < recordCount; i++) {
+        writeRecordLine(file, &records[i]);
+    }
+    long newTailOffset = ftell(file);
+    
+    char chunk[4096];
+    size_t length;
+    while ((length = fread(chunk, 1, sizeof(chunk), old)) > 0) {
+        fwrite(chunk, 1, length, file);
+    }
+    fclose(old);
+    if (fclose(file) != 0) {
+        remove(tempName);
+        printf("[ERROR] Cannot save to file!\n");
+        return;
+    }
+    
+    remove(FILENAME);
+    if (rename(tempName, FILENAME) != 0) {
+        printf("[ERROR] Cannot replace %s (data left in %s)!\n", FILENAME, tempName);
+        return;
+    }
+    unloadedTailOffset = newTailOffset;
+}
+
 // ============================================================================
 // INITIALIZE SAMPLE DATA (Minimum 10 Records)
 // ============================================================================
@@ -693,6 +869,7 @@ void initializeSampleData() {
         records[recordCount++] = sampleData[i];
     }
     
+    rebuildIndexes();
 }
 
 // ============================================================================
@@ -736,6 +913,305 @@ int generateNextID(int categoryChoice) {
     return maxID + 1;
 }
 
+// ============================================================================
+// SORTED VIEWS
+// ============================================================================
+
+// Convert a DD/MM/YYYY date into a sortable YYYYMMDD key (0 if malformed)
+int dateToKey(const char* date) {
+    static const int digitPositions[] = {0, 1, 3, 4, 6, 7, 8, 9};
+    
+    if (date == NULL || strlen(date) != 10 || date[2] != '/' || date[5] != '/') {
+        return 0;
+    }
+    for (int i = 0; i < 8; i++) {
+        if (!isdigit((unsigned char)date[digitPositions[i]])) return 0;
+    }
+    
+    int day = (date[0] - '0') * 10 + (date[1] - '0');
+    int month = (date[3] - '0') * 10 + (date[4] - '0');
+    int year = (date[6] - '0') * 1000 + (date[7] - '0') * 100 + (date[8] - '0') * 10 + (date[9] - '0');
+    return year * 10000 + month * 100 + day;
+}
+
+int compareByPrice(const Record* a, const Record* b) {
+    if (a->price < b->price) return -1;
+    if (a->price > b->price) return 1;
+    return 0;
+}
+
+int compareByDate(const Record* a, const Record* b) {
+    int keyA = dateToKey(a->date);
+    int keyB = dateToKey(b->date);
+    if (keyA < keyB) return -1;
+    if (keyA > keyB) return 1;
+    return 0;
+}
+
+// Place a slot after any entries with an equal key (binary search + shift)
+void viewInsertSlot(SortedView* view, int slot) {
+    int low = 0, high = view->count;
+    
+    while (low < high) {
+        int mid = (low + high) / 2;
+        if (view->compare(&records[view->order[mid]], &records[slot]) <= 0) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    
+    memmove(&view->order[low + 1], &view->order[low], (view->count - low) * sizeof(int));
+    view->order[low] = slot;
+    view->count++;
+}
+
+void rebuildViews() {
+    for (int v = 0; v < VIEW_COUNT; v++) {
+        views[v].count = 0;
+        for (int i = 0; i < recordCount; i++) {
+            viewInsertSlot(&views[v], i);
+        }
+    }
+}
+
+// ============================================================================
+// TABLE ROW FORMATTING
+// ============================================================================
+
+// Left-aligned text padded with spaces to width (never truncated, like %-Ns)
+size_t appendPaddedText(char* out, const char* text, int width) {
+    size_t length = strlen(text);
+    memcpy(out, text, length);
+    while ((int)length < width) out[length++] = ' ';
+    return length;
+}
+
+// Same output as %-Nd
+size_t appendPaddedInt(char* out, long value, int width) {
+    char digits[24];
+    int count = 0;
+    unsigned long magnitude = value < 0 ? 0UL - (unsigned long)value : (unsigned long)value;
+    do {
+        digits[count++] = (char)('0' + magnitude % 10);
+        magnitude /= 10;
+    } while (magnitude > 0);
+    
+    size_t length = 0;
+    if (value < 0) out[length++] = '-';
+    while (count > 0) out[length++] = digits[--count];
+    while ((int)length < width) out[length++] = ' ';
+    return length;
+}
+
+// Same output as %-N.2f: a float times 100 is exact in a double, so any value
+// that is not exactly half a cent rounds the same in every C library. Exact
+// ties go to printf, since libraries differ on them (glibc rounds to even,
+// msvcrt away from zero), and so does zero, which may carry a sign
+size_t appendPaddedMoney(char* out, float value, int width) {
+    double scaled = (double)value * 100.0;
+    double magnitude = scaled < 0 ? -scaled : scaled;
+    if (!(magnitude < 1e17) || magnitude == 0 || magnitude - (double)(long long)magnitude == 0.5) {
+        int length = snprintf(out, 48, "%-*.2f", width, value);     // Float range: at most 47 characters
+        return length < 48 ? (size_t)length : 47;
+    }
+    
+    size_t length = 0;
+    if (scaled < 0) {
+        out[length++] = '-';
+        scaled = -scaled;
+    }
+    long long cents = (long long)scaled;
+    double fraction = scaled - (double)cents;
+    if (fraction > 0.5) cents++;
+    
+    char digits[24];
+    int count = 0;
+    long long whole = cents / 100;
+    do {
+        digits[count++] = (char)('0' + whole % 10);
+        whole /= 10;
+    } while (whole > 0);
+    while (count > 0) out[length++] = digits[--count];
+    out[length++] = '.';
+    out[length++] = (char)('0' + (cents / 10) % 10);
+    out[length++] = (char)('0' + cents % 10);
+    while ((int)length < width) out[length++] = ' ';
+    return length;
+}
+
+// "| %-10d | %-36s | $%-9.2f | %-10s | %-10s |\n" without printf; returns the length
+size_t formatRecordRow(char* out, const Record* r) {
+    size_t length = 0;
+    out[length++] = '|';
+    out[length++] = ' ';
+    length += appendPaddedInt(out + length, r->id, 10);
+    length += appendPaddedText(out + length, " | ", 0);
+    length += appendPaddedText(out + length, r->productName, 36);
+    length += appendPaddedText(out + length, " | $", 0);
+    length += appendPaddedMoney(out + length, r->price, 9);
+    length += appendPaddedText(out + length, " | ", 0);
+    length += appendPaddedText(out + length, r->date, 10);
+    length += appendPaddedText(out + length, " | ", 0);
+    length += appendPaddedText(out + length, r->category, 10);
+    length += appendPaddedText(out + length, " |\n", 0);
+    return length;
+}
+
+// Room for one more row at the end of the buffer (flushing it if needed)
+char* reserveRow() {
+    if (ROW_BUFFER_SIZE - rowBufferLength < TABLE_ROW_LENGTH) flushRows();
+    return rowBuffer + rowBufferLength;
+}
+
+void printRecordRow(const Record* r) {
+    char* out = reserveRow();
+    rowBufferLength += formatRecordRow(out, r);
+}
+
+// Must be called before anything else is printed after a run of rows
+void flushRows() {
+    if (rowBufferLength > 0) {
+        fwrite(rowBuffer, 1, rowBufferLength, stdout);
+        rowBufferLength = 0;
+    }
+}
+
+// ============================================================================
+// GROUP-BY ENGINE
+// ============================================================================
+void toLowerCase(const char* src, char* dest, size_t size) {
+    size_t i;
+    if (size == 0) return;
+    for (i = 0; i + 1 < size && src[i] != '\0'; i++) {
+        dest[i] = (char)tolower((unsigned char)src[i]);
+    }
+    dest[i] = '\0';
+}
+
+unsigned int groupHash(const char* key) {
+    unsigned int h = 2166136261u;
+    for (const char* c = key; *c != '\0'; c++) {
+        h ^= (unsigned char)*c;
+        h *= 16777619u;
+    }
+    return h;
+}
+
+// Group label and match key for a record, and its numeric rank for ordering
+// (0 = by key). Names group case-insensitively, like the other indexes
+long groupKeyFor(const Record* r, int groupBy, char* key, char* label, size_t size) {
+    long rank = 0;
+    
+    if (groupBy == GROUP_BY_CATEGORY) {
+        snprintf(label, size, "%s", r->category[0] != '\0' ? r->category : "(none)");
+    } else if (groupBy == GROUP_BY_PRODUCT) {
+        snprintf(label, size, "%s [%s]", r->productName, r->category);
+    } else if (groupBy == GROUP_BY_MONTH) {
+        int dateKey = dateToKey(r->date);
+        if (dateKey == 0) {
+            snprintf(label, size, "Unknown");
+        } else {
+            snprintf(label, size, "%04d-%02d", dateKey / 10000, dateKey / 100 % 100);
+            rank = dateKey / 100;
+        }
+    } else {
+        int band = (int)(r->price / REPORT_PRICE_BAND);
+        snprintf(label, size, "$%d - $%d", band * REPORT_PRICE_BAND, (band + 1) * REPORT_PRICE_BAND);
+        rank = band + 1;
+    }
+    
+    toLowerCase(label, key, size);
+    return rank;
+}
+
+// Aggregate for key, creating an empty one (shown as label) if needed
+GroupAggregate* groupFind(GroupTable* table, const char* key, const char* label, long rank) {
+    unsigned int pos = groupHash(key) & (GROUP_TABLE_SIZE - 1);
+    while (table->slots[pos].used) {
+        if (strcmp(table->slots[pos].key, key) == 0) return &table->slots[pos];
+        pos = (pos + 1) & (GROUP_TABLE_SIZE - 1);
+    }
+    GroupAggregate* group = &table->slots[pos];
+    strcpy(group->key, key);
+    strcpy(group->label, label);
+    group->used = 1;
+    group->rank = rank;
+    table->groupCount++;
+    return group;
+}
+
+// One pass over records[] fills tables[g] grouped by key g (g < tableCount)
+void groupByRecords(GroupTable* tables, int tableCount) {
+    char key[GROUP_KEY_LENGTH];
+    char label[GROUP_KEY_LENGTH];
+    
+    for (int g = 0; g < tableCount; g++) {
+        memset(&tables[g], 0, sizeof(GroupTable));
+    }
+    for (int i = 0; i < recordCount; i++) {
+        for (int g = 0; g < tableCount; g++) {
+            long rank = groupKeyFor(&records[i], g, key, label, sizeof(key));
+            GroupAggregate* group = groupFind(&tables[g], key, label, rank);
+            if (group->count == 0 || records[i].price < group->min) group->min = records[i].price;
+            if (group->count == 0 || records[i].price > group->max) group->max = records[i].price;
+            group->count++;
+            group->sum += records[i].price;
+        }
+    }
+}
+
+int compareGroups(const void* a, const void* b) {
+    const GroupAggregate* x = *(const GroupAggregate* const*)a;
+    const GroupAggregate* y = *(const GroupAggregate* const*)b;
+    if (x->rank != y->rank) return (x->rank < y->rank) ? -1 : 1;
+    int cmp = strcmp(x->key, y->key);
+    return cmp != 0 ? cmp : strcmp(x->label, y->label);
+}
+
+// Used groups of a table in report order; returns how many
+int sortedGroups(GroupTable* table, GroupAggregate** out) {
+    int count = 0;
+    for (int s = 0; s < GROUP_TABLE_SIZE; s++) {
+        if (table->slots[s].used) out[count++] = &table->slots[s];
+    }
+    qsort(out, count, sizeof(GroupAggregate*), compareGroups);
+    return count;
+}
+
+void writeGroupSummary(FILE* file, const char* title, GroupTable* table) {
+    GroupAggregate* groups[MAX_RECORDS];
+    int count = sortedGroups(table, groups);
+    
+    fprintf(file, "\n--------------------------------------------------------------\n");
+    fprintf(file, "                    SUMMARY BY %s\n", title);
+    fprintf(file, "--------------------------------------------------------------\n");
+    fprintf(file, "%-36s %6s %14s %11s %11s %11s\n", "Group", "Items", "Total Value", "Min", "Max", "Average");
+    for (int g = 0; g < count; g++) {
+        fprintf(file, "%-36s %6d %14.2f %11.2f %11.2f %11.2f\n",
+                groups[g]->label, groups[g]->count, groups[g]->sum,
+                groups[g]->min, groups[g]->max, groups[g]->sum / groups[g]->count);
+    }
+}
+
+// ============================================================================
+// INDEX MAINTENANCE
+// Every change to records[] goes through these so secondary structures stay
+// in step with the base array
+// ============================================================================
+
+// records[slot] has just been appended
+void indexInsertRecord(int slot) {
+    for (int v = 0; v < VIEW_COUNT; v++) {
+        viewInsertSlot(&views[v], slot);
+    }
+}
+
+// Full rebuild after a load or an in-place reorder of records[]
+void rebuildIndexes() {
+    rebuildViews();
+}
+
 // ============================================================================
 // CORE OPERATIONS
 // ============================================================================
@@ -913,6 +1389,7 @@ void insertRecord() {
             // Add record to array
             records[recordCount] = newRecord;
             recordCount++;
+            indexInsertRecord(recordCount - 1);
             
             printf("[OK] Item %d added successfully! (ID: %d)\n", item + 1, newRecord.id);
         }
@@ -940,6 +1417,61 @@ void insertRecord() {
 
 // 2. DISPLAY ALL RECORDS
 void displayAllRecords() {
+    displayRecordsInView(VIEW_STORED, 0);
+}
+
+// Let the user pick an ordering; sorted views are read as-is, nothing is re-sorted
+void displayRecordsMenu() {
+    int choice;
+    
+    while (1) {
+        printf("\n==============================================================\n");
+        printf("                    DISPLAY RECORDS                           \n");
+        printf("--------------------------------------------------------------\n");
+        printf("  1. Stored Order                                            \n");
+        printf("  2. By Price (Lowest to Highest)                            \n");
+        printf("  3. By Price (Highest to Lowest)                            \n");
+        printf("  4. By Date (Oldest to Newest)                              \n");
+        printf("  5. By Date (Newest to Oldest)                              \n");
+        printf("  6. Back to Main Menu                                       \n");
+        printf("==============================================================\n");
+        printCenteredNoNL("Enter your choice (1-6): ");
+        fflush(stdout);
+        
+        if (scanf("%d", &choice) != 1) {
+            clearInputBuffer();
+            printf("[ERROR] Invalid input! Please enter a number.\n");
+            continue;
+        }
+        
+        clearInputBuffer();
+        
+        switch(choice) {
+            case 1:
+                displayRecordsInView(VIEW_STORED, 0);
+                return;
+            case 2:
+                displayRecordsInView(VIEW_PRICE, 0);
+                return;
+            case 3:
+                displayRecordsInView(VIEW_PRICE, 1);
+                return;
+            case 4:
+                displayRecordsInView(VIEW_DATE, 0);
+                return;
+            case 5:
+                displayRecordsInView(VIEW_DATE, 1);
+                return;
+            case 6:
+                return;  // Back to main menu
+            default:
+                printf("[ERROR] Invalid choice! Please select 1-6.\n");
+        }
+    }
+}
+
+// Print records in stored order (VIEW_STORED) or through a sorted view
+void displayRecordsInView(int viewId, int descending) {
     printf("\n==============================================================\n");
     printf("              ALL RECORDS                                     \n");
     printf("==============================================================\n\n");
@@ -949,17 +1481,24 @@ void displayAllRecords() {
         return;
     }
     
+    if (viewId != VIEW_STORED) {
+        printf("Order: %s (%s)\n\n", views[viewId].name, descending ? "Descending" : "Ascending");
+    }
+    
     // Display table header
     printf("+------------+--------------------------------------+------------+------------+------------+\n");
     printf("| Product ID | Product Name                         | Price      | Date       | Category   |\n");
     printf("+------------+--------------------------------------+------------+------------+------------+\n");
     
     // Display all records
-    for (int i = 0; i < recordCount; i++) {
-        printf("| %-10d | %-36s | $%-9.2f | %-10s | %-10s |\n", 
-               records[i].id, records[i].productName, 
-               records[i].price, records[i].date, records[i].category);
+    for (int n = 0; n < recordCount; n++) {
+        int i = n;
+        if (viewId != VIEW_STORED) {
+            i = views[viewId].order[descending ? recordCount - 1 - n : n];
+        }
+        printRecordRow(&records[i]);
     }
+    flushRows();
     
     printf("+------------+--------------------------------------+------------+------------+------------+\n");
     printf("\nTotal Records: %d\n", recordCount);
@@ -1023,9 +1562,10 @@ void sortMenu() {
         printf("  1. Ascending                                              \n");
         printf("  2. Descending                                             \n");
         printf("  3. Resort (reapply last sort)                             \n");
-        printf("  4. Back to Main Menu                                      \n");
+        printf("  4. External Sort (data file on disk)                      \n");
+        printf("  5. Back to Main Menu                                      \n");
         printf("==============================================================\n");
-        printf("Enter your choice (1-4): ");
+        printf("Enter your choice (1-5): ");
         fflush(stdout);
 
         if (scanf("%d", &choice) != 1) {
@@ -1113,9 +1653,12 @@ void sortMenu() {
             resortLastSort();
             return;
         } else if (choice == 4) {
+            externalSortMenu();
+            return;
+        } else if (choice == 5) {
             return; // back to main menu
         } else {
-            printf("[ERROR] Invalid choice! Please select 1-4.\n");
+            printf("[ERROR] Invalid choice! Please select 1-5.\n");
         }
         
         back_to_sort_menu: ;
@@ -1151,6 +1694,7 @@ void sortByPriceBubble(int ascending) {
         if (!swapped) break;  // Early exit if sorted
     }
 
+    rebuildIndexes();
     saveToFile();
 
     printf("[OK] Records sorted successfully!\n");
@@ -1195,6 +1739,7 @@ void sortByPriceSelection(int ascending) {
         }
     }
 
+    rebuildIndexes();
     saveToFile();
 
     printf("[OK] Records sorted successfully!\n");
@@ -1234,6 +1779,7 @@ void sortByIDBubble(int ascending) {
         if (!swapped) break;  // Early exit if sorted
     }
 
+    rebuildIndexes();
     saveToFile();
 
     printf("[OK] Records sorted successfully!\n");
@@ -1278,6 +1824,7 @@ void sortByIDSelection(int ascending) {
         }
     }
 
+    rebuildIndexes();
     saveToFile();
 
     printf("[OK] Records sorted successfully!\n");
@@ -1296,7 +1843,11 @@ void resortLastSort() {
     }
 
     printf("\n[OK] Reapplying last sort...\n");
-    if (lastSortField == 1) { // Price
+    if (lastSortAlgorithm == 3) { // External, on the data file
+        externalSortField = lastSortField;
+        externalSortAscending = lastSortOrder;
+        externalSortDataFile(externalSortBudget);
+    } else if (lastSortField == 1) { // Price
         if (lastSortAlgorithm == 1) {
             sortByPriceBubble(lastSortOrder);
         } else {
@@ -1313,6 +1864,368 @@ void resortLastSort() {
     }
 }
 
+// ============================================================================
+// EXTERNAL MERGE SORT
+// Sorts the data file on disk with a bounded amount of memory: the file is
+// cut into sorted runs that fit the budget, then runs are merged k at a time
+// ============================================================================
+int compareForExternalSort(const Record* a, const Record* b) {
+    int cmp = 0;
+    if (externalSortField == 1) {
+        cmp = (a->price > b->price) - (a->price < b->price);
+    } else {
+        cmp = (a->id > b->id) - (a->id < b->id);
+    }
+    return externalSortAscending ? cmp : -cmp;
+}
+
+int qsortExternalCompare(const void* a, const void* b) {
+    return compareForExternalSort((const Record*)a, (const Record*)b);
+}
+
+void runFileName(char* buffer, size_t size, int pass, int index) {
+    snprintf(buffer, size, "question2_run_%d_%d.tmp", pass, index);
+}
+
+// Read the next well-formed record from a run or data file; 0 at end of file
+int readRecordLine(FILE* file, Record* out) {
+    char line[300];
+    while (fgets(line, sizeof(line), file) != NULL) {
+        if (parseRecordLine(line, out)) return 1;
+    }
+    return 0;
+}
+
+void writeReportRow(FILE* file, const Record* r) {
+    char row[TABLE_ROW_LENGTH];
+    fwrite(row, 1, formatRecordRow(row, r), file);
+}
+
+// File buffer size for a memory budget: a full merge (the maximum fan-in of
+// inputs plus one output) should fit in the budget
+size_t externalSortBufferSize(size_t budgetBytes) {
+    size_t size = budgetBytes / (EXTERNAL_SORT_MAX_FANIN + 1);
+    if (size < EXTERNAL_SORT_MIN_IO_BUFFER) size = EXTERNAL_SORT_MIN_IO_BUFFER;
+    if (size > EXTERNAL_SORT_IO_BUFFER) size = EXTERNAL_SORT_IO_BUFFER;
+    return size;
+}
+
+// Delete runs [first, first+count) of a pass (missing files are ignored)
+void removeRuns(int pass, int first, int count) {
+    char name[64];
+    for (int i = first; i < first + count; i++) {
+        runFileName(name, sizeof(name), pass, i);
+        remove(name);
+    }
+}
+
+// Phase 1: cut the source into sorted runs of at most runCapacity records
+// Returns the number of runs written, or -1 on error (no runs are left behind)
+int createSortedRuns(const char* source, size_t runCapacity, size_t ioBuffer) {
+    FILE* in = fopen(source, "r");
+    if (in == NULL) {
+        printf("[ERROR] Cannot open %s!\n", source);
+        return -1;
+    }
+    setvbuf(in, NULL, _IOFBF, ioBuffer);
+    
+    Record* buffer = (Record*)malloc(runCapacity * sizeof(Record));
+    if (buffer == NULL) {
+        printf("[ERROR] Not enough memory for the sort buffer!\n");
+        fclose(in);
+        return -1;
+    }
+    
+    int runCount = 0;
+    int more = 1;
+    while (more) {
+        size_t filled = 0;
+        while (filled < runCapacity && (more = readRecordLine(in, &buffer[filled]))) {
+            filled++;
+        }
+        if (filled == 0) break;
+        
+        qsort(buffer, filled, sizeof(Record), qsortExternalCompare);
+        
+        char name[64];
+        runFileName(name, sizeof(name), 0, runCount);
+        FILE* out = fopen(name, "w");
+        if (out == NULL) {
+            printf("[ERROR] Cannot create temporary file %s!\n", name);
+            free(buffer);
+            fclose(in);
+            removeRuns(0, 0, runCount);
+            return -1;
+        }
+        setvbuf(out, NULL, _IOFBF, ioBuffer);
+        for (size_t i = 0; i < filled; i++) {
+            writeRecordLine(out, &buffer[i]);
+        }
+        fclose(out);
+        runCount++;
+    }
+    
+    free(buffer);
+    fclose(in);
+    return runCount;
+}
+
+// Heap order for the merge: smaller record first, earlier run on ties (stable)
+int mergeHeapLess(Record* heads, int a, int b) {
+    int cmp = compareForExternalSort(&heads[a], &heads[b]);
+    return cmp < 0 || (cmp == 0 && a < b);
+}
+
+void mergeHeapSiftDown(int* heap, int size, Record* heads, int pos) {
+    while (1) {
+        int smallest = pos;
+        int left = 2 * pos + 1;
+        int right = left + 1;
+        if (left < size && mergeHeapLess(heads, heap[left], heap[smallest])) smallest = left;
+        if (right < size && mergeHeapLess(heads, heap[right], heap[smallest])) smallest = right;
+        if (smallest == pos) return;
+        int temp = heap[pos];
+        heap[pos] = heap[smallest];
+        heap[smallest] = temp;
+        pos = smallest;
+    }
+}
+
+// Phase 2: k-way merge of runs [first, first+count) of a pass into out
+// Input runs are deleted once merged. Returns records written, or -1 on error
+// (the input runs are then left for the caller to remove)
+long mergeRuns(int pass, int first, int count, FILE* out, int asReport, size_t ioBuffer) {
+    FILE* inputs[EXTERNAL_SORT_MAX_FANIN];
+    Record heads[EXTERNAL_SORT_MAX_FANIN];
+    int heap[EXTERNAL_SORT_MAX_FANIN];
+    int heapSize = 0;
+    long written = 0;
+    char name[64];
+    
+    for (int i = 0; i < count; i++) {
+        runFileName(name, sizeof(name), pass, first + i);
+        inputs[i] = fopen(name, "r");
+        if (inputs[i] == NULL) {
+            printf("[ERROR] Cannot reopen temporary file %s!\n", name);
+            for (int j = 0; j < i; j++) fclose(inputs[j]);
+            return -1;
+        }
+        setvbuf(inputs[i], NULL, _IOFBF, ioBuffer);
+        if (readRecordLine(inputs[i], &heads[i])) {
+            heap[heapSize++] = i;
+        }
+    }
+    
+    for (int i = heapSize / 2 - 1; i >= 0; i--) {
+        mergeHeapSiftDown(heap, heapSize, heads, i);
+    }
+    
+    while (heapSize > 0) {
+        int run = heap[0];
+        if (asReport) {
+            writeReportRow(out, &heads[run]);
+        } else {
+            writeRecordLine(out, &heads[run]);
+        }
+        written++;
+        
+        if (!readRecordLine(inputs[run], &heads[run])) {
+            heap[0] = heap[--heapSize];  // Run exhausted
+        }
+        mergeHeapSiftDown(heap, heapSize, heads, 0);
+    }
+    
+    for (int i = 0; i < count; i++) {
+        fclose(inputs[i]);
+    }
+    removeRuns(pass, first, count);
+    return written;
+}
+
+// Sort source into out using about budgetBytes of memory: the file buffers
+// (one per open run plus the output) come out of the budget first, the rest
+// holds records. Returns the number of records written, or -1 on error; no
+// temporary files are left behind either way
+int externalSortFile(const char* source, FILE* out, size_t budgetBytes, int asReport) {
+    size_t ioBuffer = externalSortBufferSize(budgetBytes);
+    size_t runCapacity = 2;
+    if (budgetBytes > 2 * ioBuffer) {
+        runCapacity = (budgetBytes - 2 * ioBuffer) / sizeof(Record);
+        if (runCapacity < 2) runCapacity = 2;
+    }
+    int fanIn = (int)(budgetBytes / (ioBuffer + sizeof(Record))) - 1;
+    if (fanIn < 2) fanIn = 2;
+    if (fanIn > EXTERNAL_SORT_MAX_FANIN) fanIn = EXTERNAL_SORT_MAX_FANIN;
+    
+    int runCount = createSortedRuns(source, runCapacity, ioBuffer);
+    if (runCount < 0) return -1;
+    int initialRuns = runCount;
+    
+    // Merge in passes until one final merge can read every run at once
+    int pass = 0;
+    while (runCount > fanIn) {
+        int newRunCount = 0;
+        for (int first = 0; first < runCount; first += fanIn) {
+            int group = runCount - first;
+            if (group > fanIn) group = fanIn;
+            
+            char name[64];
+            runFileName(name, sizeof(name), pass + 1, newRunCount);
+            FILE* merged = fopen(name, "w");
+            long result = -1;
+            if (merged == NULL) {
+                printf("[ERROR] Cannot create temporary file %s!\n", name);
+            } else {
+                setvbuf(merged, NULL, _IOFBF, ioBuffer);
+                result = mergeRuns(pass, first, group, merged, 0, ioBuffer);
+                fclose(merged);
+            }
+            if (result < 0) {
+                // Unmerged runs of this pass, and everything the next pass has so far
+                removeRuns(pass, first, runCount - first);
+                removeRuns(pass + 1, 0, newRunCount + 1);
+                return -1;
+            }
+            newRunCount++;
+        }
+        pass++;
+        runCount = newRunCount;
+    }
+    
+    printf("   Runs: %d (up to %lu records each), merge passes: %d, %d-way\n",
+           initialRuns, (unsigned long)runCapacity, pass + 1, fanIn);
+    long written = mergeRuns(pass, 0, runCount, out, asReport, ioBuffer);
+    if (written < 0) {
+        removeRuns(pass, 0, runCount);
+        return -1;
+    }
+    return (int)written;
+}
+
+// Sort the data file on disk. When it fits in records[] it is replaced and
+// reloaded; a larger file is only written sorted to SORTED_DATA_FILENAME,
+// since reloading and saving it would drop every record past MAX_RECORDS.
+// Returns the number of records written, or -1 on error
+int externalSortDataFile(size_t budgetBytes) {
+    const char* tempName = "question2_data_sorted.tmp";
+    FILE* out = fopen(tempName, "w");
+    if (out == NULL) {
+        printf("[ERROR] Cannot create sorted data file!\n");
+        return -1;
+    }
+    setvbuf(out, NULL, _IOFBF, externalSortBufferSize(budgetBytes));
+    int written = externalSortFile(FILENAME, out, budgetBytes, 0);
+    fclose(out);
+    if (written < 0) {
+        remove(tempName);
+        return -1;
+    }
+    
+    if (written > MAX_RECORDS) {
+        remove(SORTED_DATA_FILENAME);
+        if (rename(tempName, SORTED_DATA_FILENAME) != 0) {
+            printf("[ERROR] Cannot create %s (sorted copy left in %s)!\n", SORTED_DATA_FILENAME, tempName);
+            return -1;
+        }
+        printf("\n[OK] %s holds %d records, more than the %d kept in memory.\n", FILENAME, written, MAX_RECORDS);
+        printf("   Sorted copy written to %s; %s is unchanged.\n", SORTED_DATA_FILENAME, FILENAME);
+        return written;
+    }
+    
+    remove(FILENAME);
+    if (rename(tempName, FILENAME) != 0) {
+        printf("[ERROR] Cannot replace %s (sorted copy left in %s)!\n", FILENAME, tempName);
+        return -1;
+    }
+    loadFromFile();
+    lastSortField = externalSortField;
+    lastSortAlgorithm = 3; // External
+    lastSortOrder = externalSortAscending;
+    externalSortBudget = budgetBytes;
+    printf("\n[OK] %s sorted on disk (%d records).\n", FILENAME, written);
+    return written;
+}
+
+void externalSortMenu() {
+    char input[20];
+    int outputChoice;
+    size_t budgetKB = EXTERNAL_SORT_DEFAULT_KB;
+    
+    printf("\n==============================================================\n");
+    printf("              EXTERNAL SORT (Data File on Disk)               \n");
+    printf("==============================================================\n\n");
+    
+    printf("Sort by (1 = Price, 2 = ID): ");
+    fflush(stdout);
+    if (fgets(input, sizeof(input), stdin) == NULL || (input[0] != '1' && input[0] != '2')) {
+        printf("[ERROR] Invalid choice!\n");
+        return;
+    }
+    externalSortField = input[0] - '0';
+    
+    printf("Order (1 = Ascending, 2 = Descending): ");
+    fflush(stdout);
+    if (fgets(input, sizeof(input), stdin) == NULL || (input[0] != '1' && input[0] != '2')) {
+        printf("[ERROR] Invalid choice!\n");
+        return;
+    }
+    externalSortAscending = (input[0] == '1');
+    
+    printf("Memory budget in KB (Enter for %d): ", EXTERNAL_SORT_DEFAULT_KB);
+    fflush(stdout);
+    if (fgets(input, sizeof(input), stdin) != NULL && input[0] != '\n') {
+        long kb = strtol(input, NULL, 10);
+        if (kb <= 0) {
+            printf("[ERROR] Memory budget must be a positive number!\n");
+            return;
+        }
+        budgetKB = (size_t)kb;
+    }
+    
+    printf("Output (1 = Sorted data file, 2 = Sorted report): ");
+    fflush(stdout);
+    if (fgets(input, sizeof(input), stdin) == NULL || sscanf(input, "%d", &outputChoice) != 1 ||
+        (outputChoice != 1 && outputChoice != 2)) {
+        printf("[ERROR] Invalid choice!\n");
+        return;
+    }
+    
+    // Every change is saved as it happens, so the file on disk is already
+    // current; it may also hold more records than fit in records[]
+    if (outputChoice == 1) {
+        externalSortDataFile(budgetKB * 1024);
+    } else {
+        char filename[100];
+        time_t t = time(NULL);
+        struct tm *tm_info = localtime(&t);
+        sprintf(filename, "apple_store_sorted_%04d%02d%02d_%02d%02d%02d.txt",
+                tm_info->tm_year + 1900, tm_info->tm_mon + 1, tm_info->tm_mday,
+                tm_info->tm_hour, tm_info->tm_min, tm_info->tm_sec);
+        FILE* out = fopen(filename, "w");
+        if (out == NULL) {
+            printf("[ERROR] Cannot create report file!\n");
+            return;
+        }
+        setvbuf(out, NULL, _IOFBF, externalSortBufferSize(budgetKB * 1024));
+        fprintf(out, "==============================================================\n");
+        fprintf(out, "            MY APPLE-STORE SYSTEM                             \n");
+        fprintf(out, "              SORTED STOCK REPORT                             \n");
+        fprintf(out, "==============================================================\n\n");
+        fprintf(out, "Sorted by: %s (%s)\n\n", externalSortField == 1 ? "Price" : "ID",
+                externalSortAscending ? "Ascending" : "Descending");
+        fprintf(out, "+------------+--------------------------------------+------------+------------+------------+\n");
+        fprintf(out, "| Product ID | Product Name                         | Price      | Date       | Category   |\n");
+        fprintf(out, "+------------+--------------------------------------+------------+------------+------------+\n");
+        int written = externalSortFile(FILENAME, out, budgetKB * 1024, 1);
+        fprintf(out, "+------------+--------------------------------------+------------+------------+------------+\n");
+        fprintf(out, "\nTotal Records: %d\n", written < 0 ? 0 : written);
+        fclose(out);
+        if (written < 0) return;
+        printf("\n[OK] Sorted report exported (%d records).\n", written);
+        printf("   File: %s\n", filename);
+    }
+}
+
 // 8. EXPORT STOCK REPORT
 void exportReport() {
     FILE *reportFile;
@@ -1350,46 +2263,24 @@ void exportReport() {
         
         // Write all records
         for (int i = 0; i < recordCount; i++) {
-            fprintf(reportFile, "| %-10d | %-36s | $%-9.2f | %-10s | %-10s |\n", 
-                   records[i].id, records[i].productName, 
-                   records[i].price, records[i].date, records[i].category);
+            writeReportRow(reportFile, &records[i]);
         }
         
         fprintf(reportFile, "+------------+--------------------------------------+------------+------------+------------+\n");
         
-        // Calculate totals by category
-        float totalValue = 0;
-        int iphoneCount = 0, macbookCount = 0, ipadCount = 0, airpodCount = 0, iwatchCount = 0;
-        float iphoneValue = 0, macbookValue = 0, ipadValue = 0, airpodValue = 0, iwatchValue = 0;
+        // One pass fills every summary; categories include custom ones
+        groupByRecords(reportGroups, GROUP_BY_COUNT);
+        writeGroupSummary(reportFile, "CATEGORY", &reportGroups[GROUP_BY_CATEGORY]);
+        writeGroupSummary(reportFile, "PRODUCT", &reportGroups[GROUP_BY_PRODUCT]);
+        writeGroupSummary(reportFile, "MONTH", &reportGroups[GROUP_BY_MONTH]);
+        writeGroupSummary(reportFile, "PRICE BAND", &reportGroups[GROUP_BY_PRICE_BAND]);
         
-        for (int i = 0; i < recordCount; i++) {
-            totalValue += records[i].price;
-            if (strcmp(records[i].category, "iPhones") == 0) {
-                iphoneCount++;
-                iphoneValue += records[i].price;
-            } else if (strcmp(records[i].category, "MacBooks") == 0) {
-                macbookCount++;
-                macbookValue += records[i].price;
-            } else if (strcmp(records[i].category, "iPads") == 0) {
-                ipadCount++;
-                ipadValue += records[i].price;
-            } else if (strcmp(records[i].category, "AirPods") == 0) {
-                airpodCount++;
-                airpodValue += records[i].price;
-            } else if (strcmp(records[i].category, "iWatch") == 0) {
-                iwatchCount++;
-                iwatchValue += records[i].price;
-            }
+        double totalValue = 0;
+        GroupAggregate* categories[MAX_RECORDS];
+        int categoryCount = sortedGroups(&reportGroups[GROUP_BY_CATEGORY], categories);
+        for (int g = 0; g < categoryCount; g++) {
+            totalValue += categories[g]->sum;
         }
-        
-        fprintf(reportFile, "\n--------------------------------------------------------------\n");
-        fprintf(reportFile, "                    SUMMARY BY CATEGORY                       \n");
-        fprintf(reportFile, "--------------------------------------------------------------\n");
-        fprintf(reportFile, "iPhones  : %d items, Total Value: $%.2f\n", iphoneCount, iphoneValue);
-        fprintf(reportFile, "MacBooks : %d items, Total Value: $%.2f\n", macbookCount, macbookValue);
-        fprintf(reportFile, "iPads    : %d items, Total Value: $%.2f\n", ipadCount, ipadValue);
-        fprintf(reportFile, "AirPods  : %d items, Total Value: $%.2f\n", airpodCount, airpodValue);
-        fprintf(reportFile, "iWatch   : %d items, Total Value: $%.2f\n", iwatchCount, iwatchValue);
         fprintf(reportFile, "--------------------------------------------------------------\n");
         fprintf(reportFile, "TOTAL    : %d items, Total Value: $%.2f\n", recordCount, totalValue);
     }